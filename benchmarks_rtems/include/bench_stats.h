@@ -0,0 +1,63 @@
+/*
+ * Benchmark timing and statistics. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BENCH_STATS_H__
+#define __BENCH_STATS_H__
+
+#include <rtems.h>
+
+/**
+ * Time stamps and min/avg/max statistics of the benchmarks. RTEMS 4.8 has
+ * no CPU counter API, so the stamps are the uptime, which the clock driver
+ * of the BSP interpolates between ticks with its timer (nanoseconds since
+ * the last tick). The resolution is then the one of that timer, and the
+ * cost of reading it is measured by bench_calibrate() and subtracted from
+ * every sample.
+ */
+
+typedef struct {
+
+	const char * name;
+	uint32_t count;
+	/** Nanoseconds, without the overhead of the time stamps */
+	uint32_t min_ns;
+	uint32_t max_ns;
+	uint64_t total_ns;
+
+} bench_stats_t;
+
+/** Current time stamp, in nanoseconds */
+uint64_t bench_now_ns(void);
+
+/**
+ * Measures the minimum time between two consecutive time stamps over the
+ * given number of samples. It is subtracted from every sample afterwards.
+ * Returns the statistics of the measurement itself.
+ */
+void bench_calibrate(bench_stats_t * stats, uint32_t samples);
+
+/** Empties the statistics */
+void bench_stats_reset(bench_stats_t * stats, const char * name);
+
+/** Adds the time elapsed from start_ns to end_ns */
+void bench_stats_add(bench_stats_t * stats, uint64_t start_ns, uint64_t end_ns);
+
+/** Prints the statistics in one line */
+void bench_stats_print(const bench_stats_t * stats);
+
+#endif // __BENCH_STATS_H__
@@ -0,0 +1,60 @@
+/*
+ * Kernel primitives latency benchmarks. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LATENCY_H__
+#define __LATENCY_H__
+
+#include <rtems.h>
+
+/**
+ * Latency of the kernel primitives, in the spirit of the RTEMS tmtests.
+ * Each test times every iteration separately and reports min/avg/max:
+ *
+ *  - context switch: two tasks of the same priority yield to each other,
+ *    from the stamp before the yield to the stamp in the other task;
+ *  - semaphore ping-pong: the runner releases a semaphore a higher
+ *    priority helper waits for, and obtains the one the helper releases
+ *    back (round trip, two switches);
+ *  - event wakeup: from the stamp before rtems_event_send() to the stamp
+ *    in the higher priority helper it wakes up;
+ *  - message queue round trip: the runner sends a message to a higher
+ *    priority helper and receives its reply on a second queue.
+ */
+
+/** Iterations of each test */
+#define LATENCY_ITERATIONS			5000
+
+/** Priority of the runner (the caller) and of the helper tasks */
+#define LATENCY_RUNNER_PRIORITY		10
+#define LATENCY_HELPER_PRIORITY		5
+
+/** Size of the messages of the round trip */
+#define LATENCY_MESSAGE_SIZE		16
+
+/** Tasks, semaphores and message queues created by the tests at once */
+#define LATENCY_TASKS				1
+#define LATENCY_SEMAPHORES			2
+#define LATENCY_MESSAGE_QUEUES		2
+
+/**
+ * Runs every test and prints the results. It must be called from the Init
+ * task, which runs them at LATENCY_RUNNER_PRIORITY in preemptive mode.
+ */
+void latency_benchmarks(void);
+
+#endif // __LATENCY_H__
@@ -0,0 +1,100 @@
+/*
+ * Benchmark timing and statistics. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <bench_stats.h>
+
+/** Cost of a time stamp, subtracted from every sample */
+static uint32_t bench_overhead_ns = 0;
+
+uint64_t bench_now_ns(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint64_t) uptime.tv_sec * 1000000000 + uptime.tv_nsec;
+}
+
+void bench_calibrate(bench_stats_t * stats, uint32_t samples)
+{
+	uint64_t start_ns;
+	uint32_t i;
+
+	bench_overhead_ns = 0;
+	bench_stats_reset(stats, "time stamp overhead");
+
+	for (i = 0; i < samples; i++)
+	{
+		start_ns = bench_now_ns();
+		bench_stats_add(stats, start_ns, bench_now_ns());
+	}
+
+	bench_overhead_ns = stats->min_ns;
+}
+
+void bench_stats_reset(bench_stats_t * stats, const char * name)
+{
+	stats->name = name;
+	stats->count = 0;
+	stats->min_ns = 0xFFFFFFFF;
+	stats->max_ns = 0;
+	stats->total_ns = 0;
+}
+
+void bench_stats_add(bench_stats_t * stats, uint64_t start_ns, uint64_t end_ns)
+{
+	uint64_t elapsed_ns = end_ns - start_ns;
+	uint32_t sample_ns;
+
+	if (elapsed_ns > 0xFFFFFFFF)
+	{
+		elapsed_ns = 0xFFFFFFFF;
+	}
+	sample_ns = (uint32_t) elapsed_ns;
+	sample_ns = (sample_ns > bench_overhead_ns) ?
+			sample_ns - bench_overhead_ns : 0;
+
+	stats->count++;
+	stats->total_ns += sample_ns;
+	if (sample_ns < stats->min_ns)
+	{
+		stats->min_ns = sample_ns;
+	}
+	if (sample_ns > stats->max_ns)
+	{
+		stats->max_ns = sample_ns;
+	}
+}
+
+void bench_stats_print(const bench_stats_t * stats)
+{
+	if (stats->count == 0)
+	{
+		printf("%-32s no samples\n", stats->name);
+		return;
+	}
+
+	printf("%-32s %6lu | min %8lu | avg %8lu | max %8lu ns\n", stats->name,
+			(unsigned long) stats->count,
+			(unsigned long) stats->min_ns,
+			(unsigned long) (stats->total_ns / stats->count),
+			(unsigned long) stats->max_ns);
+}
@@ -0,0 +1,225 @@
+/*
+ * Kernel primitives latency benchmarks. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <bench_stats.h>
+#include <latency.h>
+
+/** Stamp taken before the primitive, read by the task that wakes up */
+static volatile uint64_t latency_stamp_ns;
+
+/** Statistics filled by the helper tasks */
+static bench_stats_t latency_stats;
+
+static rtems_id latency_sems[LATENCY_SEMAPHORES];
+static rtems_id latency_queues[LATENCY_MESSAGE_QUEUES];
+
+static rtems_id latency_create_helper(rtems_task_priority priority,
+		rtems_task_entry entry)
+{
+	rtems_id id;
+
+	rtems_task_create(rtems_build_name('L', 'H', 'L', 'P'), priority,
+			RTEMS_MINIMUM_STACK_SIZE, RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &id);
+	rtems_task_start(id, entry, 0);
+
+	return id;
+}
+
+static rtems_task latency_switch_helper(rtems_task_argument argument)
+{
+	for (;;)
+	{
+		bench_stats_add(&latency_stats, latency_stamp_ns, bench_now_ns());
+		latency_stamp_ns = bench_now_ns();
+		rtems_task_wake_after(RTEMS_YIELD_PROCESSOR);
+	}
+}
+
+static void latency_context_switch(void)
+{
+	rtems_id helper;
+	uint32_t i;
+
+	bench_stats_reset(&latency_stats, "context switch (yield)");
+
+	// Same priority as the runner: it only runs when the runner yields
+	helper = latency_create_helper(LATENCY_RUNNER_PRIORITY,
+			latency_switch_helper);
+
+	latency_stamp_ns = bench_now_ns();
+	for (i = 0; i < LATENCY_ITERATIONS; i++)
+	{
+		rtems_task_wake_after(RTEMS_YIELD_PROCESSOR);
+		bench_stats_add(&latency_stats, latency_stamp_ns, bench_now_ns());
+		latency_stamp_ns = bench_now_ns();
+	}
+
+	rtems_task_delete(helper);
+	bench_stats_print(&latency_stats);
+}
+
+static rtems_task latency_semaphore_helper(rtems_task_argument argument)
+{
+	for (;;)
+	{
+		rtems_semaphore_obtain(latency_sems[0], RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		rtems_semaphore_release(latency_sems[1]);
+	}
+}
+
+static void latency_semaphore_ping_pong(void)
+{
+	bench_stats_t stats;
+	rtems_id helper;
+	uint64_t start_ns;
+	uint32_t i;
+
+	bench_stats_reset(&stats, "semaphore ping-pong");
+
+	for (i = 0; i < LATENCY_SEMAPHORES; i++)
+	{
+		rtems_semaphore_create(rtems_build_name('L', 'S', 'E', '0' + i), 0,
+				RTEMS_COUNTING_SEMAPHORE | RTEMS_PRIORITY, 0, &latency_sems[i]);
+	}
+	helper = latency_create_helper(LATENCY_HELPER_PRIORITY,
+			latency_semaphore_helper);
+
+	for (i = 0; i < LATENCY_ITERATIONS; i++)
+	{
+		start_ns = bench_now_ns();
+		rtems_semaphore_release(latency_sems[0]);
+		rtems_semaphore_obtain(latency_sems[1], RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		bench_stats_add(&stats, start_ns, bench_now_ns());
+	}
+
+	rtems_task_delete(helper);
+	for (i = 0; i < LATENCY_SEMAPHORES; i++)
+	{
+		rtems_semaphore_delete(latency_sems[i]);
+	}
+	bench_stats_print(&stats);
+}
+
+static rtems_task latency_event_helper(rtems_task_argument argument)
+{
+	rtems_event_set events;
+
+	for (;;)
+	{
+		rtems_event_receive(RTEMS_EVENT_0, RTEMS_EVENT_ANY, RTEMS_NO_TIMEOUT,
+				&events);
+		bench_stats_add(&latency_stats, latency_stamp_ns, bench_now_ns());
+	}
+}
+
+static void latency_event_wakeup(void)
+{
+	rtems_id helper;
+	uint32_t i;
+
+	bench_stats_reset(&latency_stats, "event send to wakeup");
+
+	helper = latency_create_helper(LATENCY_HELPER_PRIORITY,
+			latency_event_helper);
+
+	for (i = 0; i < LATENCY_ITERATIONS; i++)
+	{
+		latency_stamp_ns = bench_now_ns();
+		rtems_event_send(helper, RTEMS_EVENT_0);
+	}
+
+	rtems_task_delete(helper);
+	bench_stats_print(&latency_stats);
+}
+
+static rtems_task latency_queue_helper(rtems_task_argument argument)
+{
+	uint8_t message[LATENCY_MESSAGE_SIZE];
+	size_t size;
+
+	for (;;)
+	{
+		rtems_message_queue_receive(latency_queues[0], message, &size,
+				RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		rtems_message_queue_send(latency_queues[1], message, size);
+	}
+}
+
+static void latency_queue_round_trip(void)
+{
+	uint8_t message[LATENCY_MESSAGE_SIZE] = { 0 };
+	bench_stats_t stats;
+	rtems_id helper;
+	uint64_t start_ns;
+	size_t size;
+	uint32_t i;
+
+	bench_stats_reset(&stats, "message queue round trip");
+
+	for (i = 0; i < LATENCY_MESSAGE_QUEUES; i++)
+	{
+		rtems_message_queue_create(rtems_build_name('L', 'M', 'Q', '0' + i),
+				1, LATENCY_MESSAGE_SIZE, RTEMS_FIFO, &latency_queues[i]);
+	}
+	helper = latency_create_helper(LATENCY_HELPER_PRIORITY,
+			latency_queue_helper);
+
+	for (i = 0; i < LATENCY_ITERATIONS; i++)
+	{
+		start_ns = bench_now_ns();
+		rtems_message_queue_send(latency_queues[0], message, sizeof(message));
+		rtems_message_queue_receive(latency_queues[1], message, &size,
+				RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		bench_stats_add(&stats, start_ns, bench_now_ns());
+	}
+
+	rtems_task_delete(helper);
+	for (i = 0; i < LATENCY_MESSAGE_QUEUES; i++)
+	{
+		rtems_message_queue_delete(latency_queues[i]);
+	}
+	bench_stats_print(&stats);
+}
+
+void latency_benchmarks(void)
+{
+	rtems_task_priority old_priority;
+	rtems_mode previous_mode;
+	bench_stats_t stats;
+
+	// The helpers must be able to preempt the runner
+	rtems_task_set_priority(RTEMS_SELF, LATENCY_RUNNER_PRIORITY, &old_priority);
+	rtems_task_mode(RTEMS_PREEMPT, RTEMS_PREEMPT_MASK, &previous_mode);
+
+	printf("Kernel primitives latency: %u iterations\n", LATENCY_ITERATIONS);
+
+	bench_calibrate(&stats, LATENCY_ITERATIONS);
+	bench_stats_print(&stats);
+
+	latency_context_switch();
+	latency_semaphore_ping_pong();
+	latency_event_wakeup();
+	latency_queue_round_trip();
+
+	rtems_task_mode(previous_mode, RTEMS_PREEMPT_MASK, &previous_mode);
+	rtems_task_set_priority(RTEMS_SELF, old_priority, &old_priority);
+}
@@ -0,0 +1,41 @@
+/*
+ * Benchmarks RTEMS Project
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <rtems_config.h>
+
+/** Luckily, we have the libc! :) */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <latency.h>
+
+/**
+ * The image is built for the leon3 BSP. Without a board, it runs under
+ * QEMU with: qemu-system-sparc -M leon3_generic -nographic
+ * -kernel Debug/benchmarks_rtems
+ */
+rtems_task Init(rtems_task_argument ignored)
+{
+	// Context switch, semaphore, event and message queue latencies
+	latency_benchmarks();
+
+	/** End the system execution */
+	rtems_shutdown_executive(0);
+}
@@ -4,13 +4,19 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../src/main.c 
+../src/crash.c \
+../src/main.c \
+../src/trap.c 
 
 OBJS += \
-./src/main.o 
+./src/crash.o \
+./src/main.o \
+./src/trap.o 
 
 C_DEPS += \
-./src/main.d 
+./src/crash.d \
+./src/main.d \
+./src/trap.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,151 @@
+/*
+ * Crash snapshot. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CRASH_H__
+#define __CRASH_H__
+
+#include <rtems.h>
+
+#include <trap.h>
+
+/**
+ * Post-mortem of the fatal errors without a debugger. A fatal extension
+ * saves, before the system halts or is reset, the error, the executing
+ * task, the last task switches and the top of its stack into a snapshot in
+ * a region reserved at the top of the RAM. On the next boot, crash_init()
+ * prints the snapshot if it is valid (magic number and checksum) and
+ * invalidates it.
+ *
+ * The region is outside of the image, so neither the loader nor the
+ * start-up code write it. It must also be outside of the heap and the
+ * workspace, which the BSP places below the initial stack pointer: the
+ * stack pointer must be set to CRASH_REGION_ADDRESS or below when the
+ * image is loaded (stack command of GRMON, -stack option of mkprom).
+ * crash_init() checks it and disables the snapshot otherwise.
+ *
+ * The snapshot survives the resets that keep the RAM powered: watchdog or
+ * software resets, and reloading the image with the debugger or booting
+ * it from PROM with mkprom, unless the boot loader scrubs the whole RAM
+ * (EDAC initialisation). It is lost on a power cycle.
+ *
+ * The synchronous traps given to crash_init() become fatal errors with
+ * code CRASH_TRAP_ERROR(type), and their interrupt frame is added to the
+ * snapshot. The stack excerpt then starts at the %sp of the task.
+ *
+ * Nothing is printed on the fatal path, so the time to reboot after a
+ * fault is that of a few copies.
+ */
+
+/**
+ * End of the RAM of the board (the default of the linkcmds of the BSP:
+ * 4 MB at 0x40000000), and size and address of the reserved region
+ */
+#define CRASH_RAM_END				0x40400000
+#define CRASH_REGION_SIZE			0x1000
+#define CRASH_REGION_ADDRESS		(CRASH_RAM_END - CRASH_REGION_SIZE)
+
+/** Task switches kept in the snapshot (power of two) */
+#define CRASH_EVENTS				16
+
+/** 32-bit words of the stack kept in the snapshot */
+#define CRASH_STACK_WORDS			32
+
+/** Fatal error code of a synchronous trap */
+#define CRASH_TRAP_ERROR(type)		(0x7A700000 | (type))
+
+/** "CRSH" */
+#define CRASH_MAGIC					0x43525348
+
+typedef struct {
+
+	uint32_t ticks;
+	/** Tasks switched from and to */
+	rtems_id executing;
+	rtems_id heir;
+
+} crash_event_t;
+
+typedef struct {
+
+	uint32_t magic;
+	uint32_t ticks;
+
+	/** Arguments of the fatal extension */
+	uint32_t source;
+	uint32_t is_internal;
+	uint32_t error;
+
+	/** Executing task, 0 if none */
+	rtems_id task;
+	uint32_t priority;
+
+	/** Interrupt frame of the trap, if has_frame */
+	uint32_t has_frame;
+	CPU_Interrupt_frame frame;
+
+	/** Task switches, from the oldest to the newest */
+	uint32_t events_count;
+	crash_event_t events[CRASH_EVENTS];
+
+	/** Stack from stack_address upwards */
+	uint32_t stack_address;
+	uint32_t stack_words;
+	uint32_t stack[CRASH_STACK_WORDS];
+
+	/** Sum of the previous words */
+	uint32_t checksum;
+
+} crash_snapshot_t;
+
+/** Task switch extension. Use CRASH_EXTENSION instead. */
+void crash_switch(Thread_Control * executing, Thread_Control * heir);
+
+/** Fatal error extension. Use CRASH_EXTENSION instead. */
+void crash_fatal(Internal_errors_Source source, rtems_boolean is_internal,
+		uint32_t error);
+
+/** User extensions table entry of the crash snapshot */
+#define CRASH_EXTENSION { \
+		NULL,				/* task create */ \
+		NULL,				/* task start */ \
+		NULL,				/* task restart */ \
+		NULL,				/* task delete */ \
+		crash_switch,		/* task switch */ \
+		NULL,				/* task begin */ \
+		NULL,				/* task exitted */ \
+		crash_fatal			/* fatal */ \
+		}
+
+/**
+ * Trap policy that saves the interrupt frame and raises the fatal error
+ * CRASH_TRAP_ERROR(type). It does not return.
+ */
+trap_action_t crash_trap(const trap_info_t * info, uint32_t * result);
+
+/**
+ * Prints and invalidates the snapshot of the previous boot, if any, and
+ * makes the given synchronous traps fatal. It must be called from Init.
+ * If the workspace overlaps the reserved region, it prints a warning and
+ * the fatal errors are not saved.
+ */
+void crash_init(const uint32_t * trap_types, uint32_t count);
+
+/** Prints a snapshot */
+void crash_print(const crash_snapshot_t * snapshot);
+
+#endif // __CRASH_H__
@@ -21,6 +21,15 @@
 
 #include <rtems.h>
 
+#include <crash.h>
+
+/**
+ * Uncomment to end the task with an illegal instruction, whose crash
+ * snapshot is printed on the next boot. The initial stack pointer must
+ * leave the region of the snapshot free (see crash.h).
+ */
+// #define FORCE_CRASH
+
 rtems_task Init(rtems_task_argument arg);
 
 /** Definition of the Console Driver */
@@ -59,6 +68,9 @@ rtems_task Init(rtems_task_argument arg);
                                            RTEMS_NO_TIMESLICE | \
                                            RTEMS_INTERRUPT_LEVEL(0))
 
+/** Crash snapshot of the fatal errors */
+#define CONFIGURE_INITIAL_EXTENSIONS CRASH_EXTENSION
+
 /** Ensure that the default initialization table is defined */
 #define CONFIGURE_RTEMS_INIT_TASKS_TABLE
 
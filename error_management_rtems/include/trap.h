@@ -0,0 +1,131 @@
+/*
+ * Synchronous trap handling. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRAP_H__
+#define __TRAP_H__
+
+#include <rtems.h>
+
+/**
+ * One handler for the SPARC synchronous traps. It counts every trap per
+ * type and per faulting instruction, asks the policy installed for the
+ * type what to do, and returns to the task without printing anything, so
+ * that a fault repeated in a control loop costs a few microseconds.
+ *
+ * The ISR handler of RTEMS already resumes a synchronous trap after the
+ * faulting instruction (it returns to the saved nPC) and keeps its address
+ * in tpc. A policy can also substitute the result of the instruction: the
+ * value is written to its destination register in the interrupt frame.
+ * Only the registers saved in the frame (%g1-%g7 and the %o registers of
+ * the task) can be written; the locals and ins of the task live in the
+ * register window and are left untouched.
+ *
+ * The statistics are printed by trap_report() from a task.
+ */
+
+/** SPARC trap types */
+#define TRAP_INSTRUCTION_ACCESS		0x01
+#define TRAP_ILLEGAL_INSTRUCTION	0x02
+#define TRAP_PRIVILEGED_INSTRUCTION	0x03
+#define TRAP_FP_DISABLED			0x04
+#define TRAP_MEM_ADDRESS_NOT_ALIGNED	0x07
+#define TRAP_DATA_ACCESS			0x09
+#define TRAP_TAG_OVERFLOW			0x0A
+#define TRAP_DIVISION_BY_ZERO		0x2A
+
+/** Number of trap types */
+#define TRAP_TYPES					256
+
+/** Vector of a trap type for rtems_interrupt_catch() */
+#define TRAP_VECTOR(type)			((type) + 0x100)
+
+/** Faulting instructions with their own counters (power of two) */
+#define TRAP_MAX_SITES				32
+
+typedef enum {
+
+	/** Resume after the faulting instruction */
+	TRAP_SKIP,
+	/** Resume after the faulting instruction, writing *result to rd */
+	TRAP_SUBSTITUTE
+
+} trap_action_t;
+
+typedef struct {
+
+	uint32_t type;
+	/** Address and encoding of the faulting instruction */
+	uint32_t pc;
+	uint32_t instruction;
+	/** Times it has faulted, this one included */
+	uint32_t count;
+	CPU_Interrupt_frame * isf;
+
+} trap_info_t;
+
+/**
+ * Policy of a trap type. It runs inside the ISR, so it must not block.
+ * It may set *result and return TRAP_SUBSTITUTE.
+ */
+typedef trap_action_t (*trap_policy_t)(const trap_info_t * info,
+		uint32_t * result);
+
+typedef struct {
+
+	uint32_t type;
+	uint32_t pc;
+	uint32_t count;
+	/** Results written to the destination register */
+	uint32_t substituted;
+
+} trap_site_t;
+
+/**
+ * Installs the handler for the trap type. With a NULL policy the faulting
+ * instruction is just skipped.
+ */
+rtems_status_code trap_install(uint32_t type, trap_policy_t policy);
+
+/**
+ * Policy for TRAP_DIVISION_BY_ZERO: the quotient saturates to the
+ * largest value of its sign (0xFFFFFFFF for udiv; 0x7FFFFFFF or
+ * 0x80000000 for sdiv, after the sign of the dividend in %y).
+ */
+trap_action_t trap_division_saturate(const trap_info_t * info,
+		uint32_t * result);
+
+/**
+ * Reads a register of the task from the interrupt frame. Returns 0 if it
+ * is not saved there.
+ */
+int trap_read_register(const CPU_Interrupt_frame * isf, uint32_t reg,
+		uint32_t * value);
+
+/** Number of traps of the type */
+uint32_t trap_get_count(uint32_t type);
+
+/**
+ * Copies the counters of the faulting instructions to sites, up to max of
+ * them, and returns how many were copied.
+ */
+uint32_t trap_get_sites(trap_site_t * sites, uint32_t max);
+
+/** Prints the counters of every trap type and faulting instruction */
+void trap_report(void);
+
+#endif // __TRAP_H__
@@ -0,0 +1,260 @@
+/*
+ * Crash snapshot. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include <crash.h>
+
+/** The snapshot must fit in the reserved region */
+typedef char crash_region_check[
+		(sizeof(crash_snapshot_t) <= CRASH_REGION_SIZE) ? 1 : -1];
+
+/** Snapshot of the last fatal error, in the reserved region */
+static crash_snapshot_t * const crash_snapshot =
+		(crash_snapshot_t *) CRASH_REGION_ADDRESS;
+
+/** The reserved region is not used by the workspace */
+static int crash_enabled = 0;
+
+/** Ring of the last task switches and number of switches */
+static crash_event_t crash_events[CRASH_EVENTS];
+static uint32_t crash_events_count = 0;
+
+/** Interrupt frame of the trap that raised the fatal error */
+static CPU_Interrupt_frame crash_frame;
+static volatile int crash_frame_valid = 0;
+
+static const char * crash_sources[] = {
+	"core", "RTEMS API", "POSIX API", "ITRON API"
+};
+
+static uint32_t crash_checksum(const crash_snapshot_t * snapshot)
+{
+	const uint32_t * word = (const uint32_t *) snapshot;
+	uint32_t sum = 0;
+	uint32_t i;
+
+	for (i = 0; i < offsetof(crash_snapshot_t, checksum) / sizeof(uint32_t);
+			i++)
+	{
+		sum += word[i];
+	}
+
+	return sum;
+}
+
+void crash_switch(Thread_Control * executing, Thread_Control * heir)
+{
+	crash_event_t * event;
+
+	event = &crash_events[crash_events_count & (CRASH_EVENTS - 1)];
+	event->ticks = _Watchdog_Ticks_since_boot;
+	event->executing = executing->Object.id;
+	event->heir = heir->Object.id;
+	crash_events_count++;
+}
+
+/** Copies the top of the stack of the task, from sp to its base */
+static void crash_save_stack(crash_snapshot_t * snapshot,
+		Thread_Control * task, uint32_t sp)
+{
+	uint32_t base;
+	uint32_t words;
+
+	snapshot->stack_address = sp;
+	snapshot->stack_words = 0;
+
+	if (task == NULL)
+	{
+		return;
+	}
+
+	// Only what is inside the stack of the task: sp may be corrupt
+	base = (uint32_t) task->Start.Initial_stack.area;
+	if (sp < base || sp >= base + task->Start.Initial_stack.size
+			|| (sp & 3) != 0)
+	{
+		return;
+	}
+
+	words = (base + task->Start.Initial_stack.size - sp) / sizeof(uint32_t);
+	if (words > CRASH_STACK_WORDS)
+	{
+		words = CRASH_STACK_WORDS;
+	}
+
+	for (snapshot->stack_words = 0; snapshot->stack_words < words;
+			snapshot->stack_words++)
+	{
+		snapshot->stack[snapshot->stack_words] =
+				((const uint32_t *) sp)[snapshot->stack_words];
+	}
+}
+
+void crash_fatal(Internal_errors_Source source, rtems_boolean is_internal,
+		uint32_t error)
+{
+	crash_snapshot_t * snapshot = crash_snapshot;
+	Thread_Control * task = _Thread_Executing;
+	uint32_t first;
+	uint32_t sp;
+	uint32_t i;
+
+	if (!crash_enabled)
+	{
+		return;
+	}
+
+	snapshot->magic = 0;
+	snapshot->ticks = _Watchdog_Ticks_since_boot;
+	snapshot->source = source;
+	snapshot->is_internal = is_internal;
+	snapshot->error = error;
+
+	snapshot->task = (task != NULL) ? task->Object.id : 0;
+	snapshot->priority = (task != NULL) ? task->current_priority : 0;
+
+	// The stack of a trap is the one of the task, not of the ISR
+	snapshot->has_frame = crash_frame_valid;
+	if (crash_frame_valid)
+	{
+		snapshot->frame = crash_frame;
+		sp = crash_frame.i6;
+	}
+	else
+	{
+		__asm__ __volatile__ ("mov %%sp, %0" : "=r" (sp));
+	}
+	crash_save_stack(snapshot, task, sp);
+
+	snapshot->events_count = (crash_events_count < CRASH_EVENTS) ?
+			crash_events_count : CRASH_EVENTS;
+	first = crash_events_count - snapshot->events_count;
+	for (i = 0; i < snapshot->events_count; i++)
+	{
+		snapshot->events[i] = crash_events[(first + i) & (CRASH_EVENTS - 1)];
+	}
+
+	snapshot->magic = CRASH_MAGIC;
+	snapshot->checksum = crash_checksum(snapshot);
+}
+
+trap_action_t crash_trap(const trap_info_t * info, uint32_t * result)
+{
+	crash_frame = *info->isf;
+	crash_frame_valid = 1;
+
+	rtems_fatal_error_occurred(CRASH_TRAP_ERROR(info->type));
+
+	return TRAP_SKIP;
+}
+
+void crash_print(const crash_snapshot_t * snapshot)
+{
+	const CPU_Interrupt_frame * frame = &snapshot->frame;
+	uint32_t i;
+
+	printf("CRASH at tick %lu\n", (unsigned long) snapshot->ticks);
+
+	printf("  error 0x%08lX (%s, %s)", (unsigned long) snapshot->error,
+			(snapshot->source < sizeof(crash_sources) / sizeof(crash_sources[0])) ?
+					crash_sources[snapshot->source] : "unknown source",
+			snapshot->is_internal ? "internal" : "external");
+	if ((snapshot->error & ~0xFF) == CRASH_TRAP_ERROR(0))
+	{
+		printf(": trap 0x%02lX", (unsigned long) (snapshot->error & 0xFF));
+	}
+	printf("\n");
+
+	printf("  task 0x%08lX, priority %lu\n", (unsigned long) snapshot->task,
+			(unsigned long) snapshot->priority);
+
+	if (snapshot->has_frame)
+	{
+		printf("  psr 0x%08lX pc 0x%08lX npc 0x%08lX tpc 0x%08lX y 0x%08lX\n",
+				(unsigned long) frame->psr, (unsigned long) frame->pc,
+				(unsigned long) frame->npc, (unsigned long) frame->tpc,
+				(unsigned long) frame->y);
+		printf("  g1 %08lX %08lX %08lX %08lX %08lX %08lX %08lX\n",
+				(unsigned long) frame->g1, (unsigned long) frame->g2,
+				(unsigned long) frame->g3, (unsigned long) frame->g4,
+				(unsigned long) frame->g5, (unsigned long) frame->g6,
+				(unsigned long) frame->g7);
+		printf("  o0 %08lX %08lX %08lX %08lX %08lX %08lX %08lX %08lX\n",
+				(unsigned long) frame->i0, (unsigned long) frame->i1,
+				(unsigned long) frame->i2, (unsigned long) frame->i3,
+				(unsigned long) frame->i4, (unsigned long) frame->i5,
+				(unsigned long) frame->i6, (unsigned long) frame->i7);
+	}
+
+	printf("  last %lu task switches:\n", (unsigned long) snapshot->events_count);
+	for (i = 0; i < snapshot->events_count; i++)
+	{
+		printf("    %8lu: 0x%08lX -> 0x%08lX\n",
+				(unsigned long) snapshot->events[i].ticks,
+				(unsigned long) snapshot->events[i].executing,
+				(unsigned long) snapshot->events[i].heir);
+	}
+
+	printf("  stack at 0x%08lX:", (unsigned long) snapshot->stack_address);
+	for (i = 0; i < snapshot->stack_words; i++)
+	{
+		if (i % 4 == 0)
+		{
+			printf("\n    0x%08lX:", (unsigned long)
+					(snapshot->stack_address + i * sizeof(uint32_t)));
+		}
+		printf(" %08lX", (unsigned long) snapshot->stack[i]);
+	}
+	printf("\n");
+}
+
+void crash_init(const uint32_t * trap_types, uint32_t count)
+{
+	uint32_t workspace_end;
+	uint32_t i;
+
+	workspace_end = (uint32_t) rtems_configuration_get_work_space_start()
+			+ rtems_configuration_get_work_space_size();
+	if (workspace_end > CRASH_REGION_ADDRESS)
+	{
+		printf("CRASH: workspace up to 0x%08lX, set the initial stack pointer "
+				"to 0x%08lX or below to save the fatal errors\n",
+				(unsigned long) workspace_end,
+				(unsigned long) CRASH_REGION_ADDRESS);
+	}
+	else
+	{
+		if (crash_snapshot->magic == CRASH_MAGIC
+				&& crash_snapshot->checksum == crash_checksum(crash_snapshot)
+				&& crash_snapshot->events_count <= CRASH_EVENTS
+				&& crash_snapshot->stack_words <= CRASH_STACK_WORDS)
+		{
+			crash_print(crash_snapshot);
+		}
+		crash_snapshot->magic = 0;
+		crash_enabled = 1;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		trap_install(trap_types[i], crash_trap);
+	}
+}
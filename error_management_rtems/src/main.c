@@ -19,6 +19,8 @@
 #include <rtems.h>
 
 #include <rtems_config.h>
+#include <trap.h>
+#include <crash.h>
 
 /** Luckily, we have the libc! :) */
 #include <stdio.h>
@@ -34,38 +36,62 @@
 			} while (0)
 
 
-void force_division_by_zero(void)
+/** Divisions by zero of the control loop */
+#define CONTROL_LOOP_ITERATIONS		1000
+
+/** Synchronous traps that end in a crash snapshot */
+static const uint32_t fatal_traps[] = {
+	TRAP_INSTRUCTION_ACCESS, TRAP_ILLEGAL_INSTRUCTION,
+	TRAP_PRIVILEGED_INSTRUCTION, TRAP_FP_DISABLED,
+	TRAP_MEM_ADDRESS_NOT_ALIGNED, TRAP_DATA_ACCESS
+};
+
+uint32_t force_division_by_zero(void)
 {
 	uint32_t dummy = 12345;
 	uint32_t result = 0;
 
     __asm__ __volatile__ (
             "udiv %1, 0, %0" : "=r" (result) : "r" (dummy) );
-}
-
-/** ISR for the divide-by-zero trap */
-void divide_by_zero_isr(rtems_vector_number vector)
-{
-	CPU_Interrupt_frame * isf;
-
-	__asm__ __volatile__ (
-	            "mov %%i1, %0" : "=r" (isf) : );
 
-	PRINT("Division by zero on address (0x%X)", isf->tpc);
-	return;
+	return result;
 }
 
 /**
- * This task forces a divide-by-zero error.
+ * This task forces a divide-by-zero error, and then the same error on
+ * every iteration of a control loop to measure what a trap costs.
  */
 rtems_task the_task(rtems_task_argument argument)
 {
+	struct timespec start, end;
+	uint32_t elapsed_ns;
+	uint32_t result;
+	uint32_t i;
 
 	PRINT_TIME("Task Starts");
 
-	force_division_by_zero();
+	result = force_division_by_zero();
 
-	PRINT_TIME("I'm still alive!");
+	PRINT_TIME("I'm still alive! (result 0x%X)", result);
+
+	rtems_clock_get_uptime(&start);
+	for (i = 0; i < CONTROL_LOOP_ITERATIONS; i++)
+	{
+		result = force_division_by_zero();
+	}
+	rtems_clock_get_uptime(&end);
+
+	elapsed_ns = (end.tv_sec - start.tv_sec) * 1000000000
+			+ end.tv_nsec - start.tv_nsec;
+	PRINT_TIME("%d divisions by zero: %d ns each", CONTROL_LOOP_ITERATIONS,
+			elapsed_ns / CONTROL_LOOP_ITERATIONS);
+
+	trap_report();
+
+#ifdef FORCE_CRASH
+	PRINT_TIME("Executing an illegal instruction");
+	__asm__ __volatile__ ("unimp 0");
+#endif
 
 	rtems_task_delete(RTEMS_SELF);
 }
@@ -74,14 +100,16 @@ rtems_task the_task(rtems_task_argument argument)
 rtems_task Init(rtems_task_argument arg)
 {
 	rtems_id the_task_id;
-	rtems_isr_entry old_isr;
 
-	// TODO: Install the handler for the SYNCHRONOUS INTERRUPT
-	// "divide by zero" trap (0x2A)
-	rtems_interrupt_catch(divide_by_zero_isr, 0x2A + 0x100, &old_isr);
+	// Print the crash of the previous boot, if any
+	crash_init(fatal_traps, sizeof(fatal_traps) / sizeof(fatal_traps[0]));
+
+	// Install the handler for the SYNCHRONOUS INTERRUPT
+	// "divide by zero" trap (0x2A): the quotient saturates
+	trap_install(TRAP_DIVISION_BY_ZERO, trap_division_saturate);
 
 	rtems_task_create(rtems_build_name('T', 'a', 's', 'k'),
-			10, RTEMS_MINIMUM_STACK_SIZE,
+			10, 2 * RTEMS_MINIMUM_STACK_SIZE,
 			RTEMS_PREEMPT | RTEMS_TIMESLICE,
 			RTEMS_DEFAULT_ATTRIBUTES, &the_task_id);
 
@@ -0,0 +1,263 @@
+/*
+ * Synchronous trap handling. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <trap.h>
+
+/** Fields of a format 3 instruction (arithmetic, loads and stores) */
+#define TRAP_INSN_OP(insn)		((insn) >> 30)
+#define TRAP_INSN_RD(insn)		(((insn) >> 25) & 0x1F)
+#define TRAP_INSN_OP3(insn)		(((insn) >> 19) & 0x3F)
+
+/** op3 of the signed divisions (sdiv, sdivcc) */
+#define TRAP_OP3_SDIV			0x0F
+#define TRAP_OP3_SDIVCC			0x1F
+
+static trap_policy_t trap_policies[TRAP_TYPES];
+static volatile uint32_t trap_counts[TRAP_TYPES];
+
+/** Open addressing table of the faulting instructions */
+static trap_site_t trap_sites[TRAP_MAX_SITES];
+
+/** Traps whose instruction did not fit in trap_sites */
+static volatile uint32_t trap_sites_overflow = 0;
+
+/** Traps whose result could not be written to the destination register */
+static volatile uint32_t trap_lost_results = 0;
+
+/**
+ * Address of a register of the task in the interrupt frame: %g1-%g7 and
+ * the %o registers of the task, which are the %i registers of the trap
+ * window. Both groups are consecutive in the frame.
+ */
+static uint32_t * trap_register(CPU_Interrupt_frame * isf, uint32_t reg)
+{
+	if (reg >= 1 && reg <= 7)
+	{
+		return &isf->g1 + (reg - 1);
+	}
+	if (reg >= 8 && reg <= 15)
+	{
+		return &isf->i0 + (reg - 8);
+	}
+	return NULL;
+}
+
+int trap_read_register(const CPU_Interrupt_frame * isf, uint32_t reg,
+		uint32_t * value)
+{
+	uint32_t * address;
+
+	if (reg == 0)
+	{
+		*value = 0;
+		return 1;
+	}
+
+	address = trap_register((CPU_Interrupt_frame *) isf, reg);
+	if (address == NULL)
+	{
+		return 0;
+	}
+	*value = *address;
+	return 1;
+}
+
+/** Counts the trap at its instruction and returns the site, if any */
+static trap_site_t * trap_count_site(uint32_t type, uint32_t pc)
+{
+	rtems_interrupt_level level;
+	trap_site_t * site = NULL;
+	uint32_t index;
+	uint32_t i;
+
+	index = ((pc >> 2) ^ type) & (TRAP_MAX_SITES - 1);
+
+	rtems_interrupt_disable(level);
+	for (i = 0; i < TRAP_MAX_SITES; i++)
+	{
+		site = &trap_sites[index];
+		if (site->count == 0)
+		{
+			site->type = type;
+			site->pc = pc;
+			break;
+		}
+		if (site->pc == pc && site->type == type)
+		{
+			break;
+		}
+		index = (index + 1) & (TRAP_MAX_SITES - 1);
+	}
+	if (i == TRAP_MAX_SITES)
+	{
+		site = NULL;
+		trap_sites_overflow++;
+	}
+	else
+	{
+		site->count++;
+	}
+	rtems_interrupt_enable(level);
+
+	return site;
+}
+
+/**
+ * Handler of every installed trap. The ISR handler of RTEMS passes the
+ * interrupt frame as a second argument, and has already set pc and npc to
+ * resume after the faulting instruction, whose address is in tpc.
+ */
+static rtems_isr trap_isr(rtems_vector_number vector, CPU_Interrupt_frame * isf)
+{
+	uint32_t type = vector & (TRAP_TYPES - 1);
+	trap_policy_t policy = trap_policies[type];
+	trap_site_t * site;
+	trap_info_t info;
+	uint32_t * destination;
+	uint32_t result;
+
+	trap_counts[type]++;
+	site = trap_count_site(type, isf->tpc);
+
+	if (policy == NULL)
+	{
+		return;
+	}
+
+	info.type = type;
+	info.pc = isf->tpc;
+	info.instruction = *(volatile uint32_t *) isf->tpc;
+	info.count = (site != NULL) ? site->count : 0;
+	info.isf = isf;
+
+	if (policy(&info, &result) != TRAP_SUBSTITUTE)
+	{
+		return;
+	}
+
+	// Only format 3 instructions have a destination register
+	destination = NULL;
+	if (TRAP_INSN_OP(info.instruction) >= 2)
+	{
+		destination = trap_register(isf, TRAP_INSN_RD(info.instruction));
+	}
+
+	if (destination == NULL)
+	{
+		trap_lost_results++;
+		return;
+	}
+
+	*destination = result;
+	if (site != NULL)
+	{
+		site->substituted++;
+	}
+}
+
+rtems_status_code trap_install(uint32_t type, trap_policy_t policy)
+{
+	rtems_isr_entry old_isr;
+
+	if (type >= TRAP_TYPES)
+	{
+		return RTEMS_INVALID_NUMBER;
+	}
+
+	trap_policies[type] = policy;
+
+	return rtems_interrupt_catch((rtems_isr_entry) trap_isr, TRAP_VECTOR(type),
+			&old_isr);
+}
+
+trap_action_t trap_division_saturate(const trap_info_t * info,
+		uint32_t * result)
+{
+	uint32_t op3 = TRAP_INSN_OP3(info->instruction);
+
+	if (op3 != TRAP_OP3_SDIV && op3 != TRAP_OP3_SDIVCC)
+	{
+		*result = 0xFFFFFFFF;
+		return TRAP_SUBSTITUTE;
+	}
+
+	// The dividend is %y:rs1, so its sign is the one of %y
+	*result = ((int32_t) info->isf->y < 0) ? 0x80000000 : 0x7FFFFFFF;
+
+	return TRAP_SUBSTITUTE;
+}
+
+uint32_t trap_get_count(uint32_t type)
+{
+	return (type < TRAP_TYPES) ? trap_counts[type] : 0;
+}
+
+uint32_t trap_get_sites(trap_site_t * sites, uint32_t max)
+{
+	rtems_interrupt_level level;
+	uint32_t copied = 0;
+	uint32_t i;
+
+	for (i = 0; i < TRAP_MAX_SITES && copied < max; i++)
+	{
+		rtems_interrupt_disable(level);
+		if (trap_sites[i].count != 0)
+		{
+			sites[copied++] = trap_sites[i];
+		}
+		rtems_interrupt_enable(level);
+	}
+
+	return copied;
+}
+
+void trap_report(void)
+{
+	trap_site_t sites[TRAP_MAX_SITES];
+	uint32_t count;
+	uint32_t i;
+
+	printf("TRAPS\n");
+	for (i = 0; i < TRAP_TYPES; i++)
+	{
+		if (trap_counts[i] != 0)
+		{
+			printf("  type 0x%02lX: %lu\n", (unsigned long) i,
+					(unsigned long) trap_counts[i]);
+		}
+	}
+
+	count = trap_get_sites(sites, TRAP_MAX_SITES);
+	for (i = 0; i < count; i++)
+	{
+		printf("  0x%08lX type 0x%02lX: %lu (%lu substituted)\n",
+				(unsigned long) sites[i].pc, (unsigned long) sites[i].type,
+				(unsigned long) sites[i].count,
+				(unsigned long) sites[i].substituted);
+	}
+
+	if (trap_sites_overflow != 0 || trap_lost_results != 0)
+	{
+		printf("  %lu traps not counted per instruction, %lu results lost\n",
+				(unsigned long) trap_sites_overflow,
+				(unsigned long) trap_lost_results);
+	}
+}
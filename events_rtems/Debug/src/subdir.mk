@@ -4,16 +4,40 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/async_log.c \
 ../src/consume_ticks.c \
-../src/main.c 
+../src/counted_event.c \
+../src/cpu_usage.c \
+../src/event_bus.c \
+../src/event_dispatcher.c \
+../src/event_log.c \
+../src/event_profiler.c \
+../src/main.c \
+../src/periodic.c 
 
 OBJS += \
+./src/async_log.o \
 ./src/consume_ticks.o \
-./src/main.o 
+./src/counted_event.o \
+./src/cpu_usage.o \
+./src/event_bus.o \
+./src/event_dispatcher.o \
+./src/event_log.o \
+./src/event_profiler.o \
+./src/main.o \
+./src/periodic.o 
 
 C_DEPS += \
+./src/async_log.d \
 ./src/consume_ticks.d \
-./src/main.d 
+./src/counted_event.d \
+./src/cpu_usage.d \
+./src/event_bus.d \
+./src/event_dispatcher.d \
+./src/event_log.d \
+./src/event_profiler.d \
+./src/main.d \
+./src/periodic.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,78 @@
+/*
+ * Counted events. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __COUNTED_EVENT_H__
+#define __COUNTED_EVENT_H__
+
+#include <rtems.h>
+
+/**
+ * Counted events. RTEMS events are single bits: if the same event is sent
+ * twice before the receiver gets it, one occurrence is lost. A counted
+ * event receiver keeps an occurrence counter per event. The sender
+ * increments it and only sends the RTEMS event on the 0 to 1 transition,
+ * and the receiver takes all the counts at once after each receive.
+ *
+ * The counters are updated with interrupts disabled, so senders may be
+ * tasks or interrupt handlers.
+ */
+typedef struct {
+
+	/** Receiving task */
+	rtems_id task;
+	/** Pending occurrences of each event */
+	volatile uint32_t counts[32];
+	/** Uptime, in microseconds, of the last occurrence of each event */
+	volatile uint32_t stamps_us[32];
+
+} counted_event_receiver_t;
+
+/** Binds a receiver to its task */
+void counted_event_receiver_init(counted_event_receiver_t * receiver,
+		rtems_id task);
+
+/**
+ * Signals one occurrence of each of the given events. A kernel call is
+ * only made for the events that had no pending occurrence.
+ */
+rtems_status_code counted_event_send(counted_event_receiver_t * receiver,
+		rtems_event_set events);
+
+/**
+ * Signals count occurrences of each of the given events, the last one at
+ * the given uptime in microseconds. It is meant to forward the counts and
+ * time stamps taken from another receiver.
+ */
+rtems_status_code counted_event_post(counted_event_receiver_t * receiver,
+		rtems_event_set events, uint32_t count, uint32_t stamp_us);
+
+/**
+ * Waits for the given events as rtems_event_receive() does. On success,
+ * counts[n] holds the number of occurrences of RTEMS_EVENT_n taken (0 for
+ * the events not in event_in) and event_out the set of events with at
+ * least one occurrence. If stamps_us is not NULL, stamps_us[n] holds the
+ * uptime, in microseconds, of the last occurrence taken of RTEMS_EVENT_n
+ * (only meaningful when counts[n] is not 0). It must only be called by the
+ * receiving task.
+ */
+rtems_status_code counted_event_receive(counted_event_receiver_t * receiver,
+		rtems_event_set event_in, rtems_option option_set,
+		rtems_interval ticks, uint32_t counts[32], uint32_t stamps_us[32],
+		rtems_event_set * event_out);
+
+#endif // __COUNTED_EVENT_H__
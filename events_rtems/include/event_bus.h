@@ -0,0 +1,84 @@
+/*
+ * Publish/subscribe event bus. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __EVENT_BUS_H__
+#define __EVENT_BUS_H__
+
+#include <rtems.h>
+
+#include <counted_event.h>
+
+/**
+ * Publish/subscribe event bus. Topics are event bits. Subscribers are
+ * counted event receivers that register once, at init, for a set of
+ * topics; the bus keeps a bitmap of the subscribers of each topic, so
+ * publishers do not need to know who is listening.
+ *
+ * In immediate mode, publishing signals each subscriber of the published
+ * topics once, in the context of the publisher. In deferred mode, the
+ * publisher only signals the bus task, at a fixed cost, and the bus task
+ * does the fan-out later on, keeping the counts and the time stamps of
+ * the published events.
+ */
+
+/** Maximum number of subscribers of a bus */
+#define EVENT_BUS_MAX_SUBSCRIBERS	8
+
+typedef struct {
+
+	/** Registered subscribers */
+	counted_event_receiver_t * subscribers[EVENT_BUS_MAX_SUBSCRIBERS];
+	/** Topics of each subscriber */
+	rtems_event_set subscriber_topics[EVENT_BUS_MAX_SUBSCRIBERS];
+	unsigned int subscriber_count;
+
+	/** Bitmap of the subscribers of each topic, indexed by event number */
+	uint32_t topic_subscribers[32];
+	/** Topics with at least one subscriber */
+	rtems_event_set topics;
+
+	/** Deferred mode: the bus task and the receiver of its events */
+	int deferred;
+	rtems_id task_id;
+	counted_event_receiver_t task_events;
+
+} event_bus_t;
+
+/** Initializes a bus in immediate mode, with no subscribers */
+void event_bus_init(event_bus_t * bus);
+
+/**
+ * Subscribes a receiver to a set of topics. Subscribing again adds
+ * topics. It must be done before publishing to the bus. Returns
+ * RTEMS_TOO_MANY if there is no room for a new subscriber.
+ */
+rtems_status_code event_bus_subscribe(event_bus_t * bus,
+		counted_event_receiver_t * receiver, rtems_event_set topics);
+
+/**
+ * Switches the bus to deferred mode, creating and starting its task with
+ * the given priority. It must be called from Init, after all the
+ * subscriptions.
+ */
+rtems_status_code event_bus_start_deferred(event_bus_t * bus, rtems_name name,
+		rtems_task_priority priority);
+
+/** Publishes one occurrence of each of the given topics */
+rtems_status_code event_bus_publish(event_bus_t * bus, rtems_event_set topics);
+
+#endif // __EVENT_BUS_H__
@@ -0,0 +1,84 @@
+/*
+ * Event dispatcher. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __EVENT_DISPATCHER_H__
+#define __EVENT_DISPATCHER_H__
+
+#include <rtems.h>
+
+/**
+ * Event dispatcher. A table, built at init, maps each event bit to a name
+ * and a handler. The receiving task waits for the mask of the registered
+ * events and the dispatcher calls the handlers of the events received,
+ * walking the set bits only.
+ */
+
+/**
+ * Handler of an event. It gets the event (a single RTEMS_EVENT_n bit), its
+ * number of occurrences, the uptime in microseconds of the last one and
+ * the argument given at registration.
+ */
+typedef void (*event_handler_t)(rtems_event_set event, uint32_t count,
+		uint32_t stamp_us, void * arg);
+
+typedef struct {
+
+	const char * name;
+	event_handler_t handler;
+	void * arg;
+
+} event_dispatcher_entry_t;
+
+typedef struct {
+
+	/** Entry of each event, indexed by event number */
+	event_dispatcher_entry_t entries[32];
+	/** Registered events */
+	rtems_event_set mask;
+
+} event_dispatcher_t;
+
+/** Empties the table */
+void event_dispatcher_init(event_dispatcher_t * dispatcher);
+
+/**
+ * Registers the handler of an event (a single RTEMS_EVENT_n bit). Returns
+ * RTEMS_INVALID_NUMBER if event is not a single bit and
+ * RTEMS_RESOURCE_IN_USE if it already has a handler.
+ */
+rtems_status_code event_dispatcher_register(event_dispatcher_t * dispatcher,
+		rtems_event_set event, const char * name, event_handler_t handler,
+		void * arg);
+
+/** Returns the set of registered events, to be used as receive mask */
+rtems_event_set event_dispatcher_mask(const event_dispatcher_t * dispatcher);
+
+/** Returns the name of an event, or NULL if it is not registered */
+const char * event_dispatcher_name(const event_dispatcher_t * dispatcher,
+		rtems_event_set event);
+
+/**
+ * Calls the handler of each registered event in events, in increasing
+ * event number order, with the counts and time stamps taken by
+ * counted_event_receive().
+ */
+void event_dispatcher_dispatch(const event_dispatcher_t * dispatcher,
+		rtems_event_set events, const uint32_t counts[32],
+		const uint32_t stamps_us[32]);
+
+#endif // __EVENT_DISPATCHER_H__
@@ -0,0 +1,74 @@
+/*
+ * Event log ring buffer. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __EVENT_LOG_H__
+#define __EVENT_LOG_H__
+
+#include <rtems.h>
+
+/**
+ * In-memory event log. Records are written in O(1) by a single task (the
+ * logging server) and printed in bulk by a low priority dump task, either
+ * on request or when no other task is ready to run.
+ */
+
+/** Number of records of the log. It must be a power of two. */
+#define EVENT_LOG_SIZE			256
+
+/** Priority of the dump task, just above the log drain task */
+#define EVENT_LOG_DUMP_PRIORITY		249
+
+/** Period, in ticks, of the dump task when it is not requested */
+#define EVENT_LOG_IDLE_PERIOD		10
+
+/** Event that requests a dump to the dump task */
+#define EVENT_LOG_DUMP_REQUEST		RTEMS_EVENT_31
+
+typedef struct {
+
+	/** Tick of the event */
+	uint32_t tick;
+	/** Task that signaled the event */
+	rtems_id source;
+	/** Event number (0 to 31) */
+	uint32_t event;
+	/** Sequence number, global to the log */
+	uint32_t sequence;
+
+} event_log_record_t;
+
+/** Creates and starts the dump task. It must be called from Init. */
+rtems_status_code event_log_init(void);
+
+/** Sets the name printed for an event (a single RTEMS_EVENT_n bit) */
+void event_log_set_name(rtems_event_set event, const char * name);
+
+/**
+ * Stores an occurrence of an event (a single RTEMS_EVENT_n bit). If the
+ * log is full, the record is dropped and counted. Only one task may write
+ * into the log.
+ */
+void event_log_write(rtems_id source, rtems_event_set event);
+
+/** Asks the dump task to print the log as soon as possible */
+void event_log_request_dump(void);
+
+/** Prints all the pending records. Returns the number of records printed. */
+unsigned int event_log_dump(void);
+
+#endif // __EVENT_LOG_H__
@@ -0,0 +1,110 @@
+/*
+ * Event activity profiler. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __EVENT_PROFILER_H__
+#define __EVENT_PROFILER_H__
+
+#include <rtems.h>
+
+/**
+ * Activity profiler. An activity is a span of a periodic task delimited by
+ * a start event and an end event. The profiler pairs both events, using
+ * the send time stamps of the counted events, and keeps per activity
+ * statistics of:
+ * - the execution time: from the start event to the end event.
+ * - the response time: from the release of the job to the end event. The
+ *   releases are estimated as the earliest start events seen so far plus
+ *   a whole number of periods, so that the estimation converges to the
+ *   actual phase of the task. A start event one period or more after the
+ *   expected release keeps the nominal release, advanced by whole periods:
+ *   its response includes the delay, and the periods skipped are counted
+ *   as overruns.
+ * The 99th percentile is taken from a histogram that spans one period of
+ * the activity. Every EVENT_PROFILER_REPORT_JOBS jobs, the statistics of
+ * the activity are logged.
+ */
+
+/** Maximum number of activities */
+#define EVENT_PROFILER_MAX_ACTIVITIES	8
+
+/** Histogram buckets, spread over one period of the activity */
+#define EVENT_PROFILER_BUCKETS		128
+
+/** Jobs between two reports of an activity */
+#define EVENT_PROFILER_REPORT_JOBS	20
+
+typedef struct {
+
+	/** Number of samples */
+	uint32_t samples;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+	/** Samples per bucket. The last one also holds the longer ones. */
+	uint32_t histogram[EVENT_PROFILER_BUCKETS];
+
+} event_profiler_stats_t;
+
+typedef struct {
+
+	const char * name;
+	rtems_event_set start_event;
+	rtems_event_set end_event;
+	/** Period and histogram bucket width, in microseconds */
+	uint32_t period_us;
+	uint32_t bucket_us;
+
+	/** A start event is waiting for its end event */
+	int started;
+	uint32_t start_us;
+	/** Estimated release of the current job, valid once synchronized */
+	int synchronized;
+	uint32_t release_us;
+
+	/** Jobs profiled */
+	uint32_t jobs;
+	/** Releases skipped by jobs that started one period or more late */
+	uint32_t overruns;
+	/** Events that could not be paired */
+	uint32_t unpaired;
+
+	event_profiler_stats_t execution;
+	event_profiler_stats_t response;
+
+} event_profiler_activity_t;
+
+/**
+ * Registers an activity with the given events (single RTEMS_EVENT_n bits)
+ * and period, in ticks. It must be called before the first call to
+ * event_profiler_process(). Returns RTEMS_TOO_MANY if there is no room.
+ */
+rtems_status_code event_profiler_register(const char * name,
+		rtems_event_set start_event, rtems_event_set end_event,
+		rtems_interval period);
+
+/**
+ * Feeds the profiler with the events taken by counted_event_receive().
+ * It must be called by a single task.
+ */
+void event_profiler_process(rtems_event_set events, const uint32_t counts[32],
+		const uint32_t stamps_us[32]);
+
+/** Logs the statistics of an activity */
+void event_profiler_report(const event_profiler_activity_t * activity);
+
+#endif // __EVENT_PROFILER_H__
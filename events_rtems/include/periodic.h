@@ -0,0 +1,73 @@
+/*
+ * Periodic activation helper functions. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PERIODIC_H__
+#define __PERIODIC_H__
+
+#include <rtems.h>
+
+/**
+ * Periodic activation based on a rate monotonic period, with overrun
+ * detection and release jitter statistics. A periodic_t must be created
+ * and used by the same task, as it owns the rate monotonic period.
+ */
+typedef struct {
+
+	/** Rate monotonic period ID */
+	rtems_id period_id;
+	/** Period, in ticks */
+	rtems_interval period;
+
+	/** Nominal release tick of the current activation */
+	uint32_t release_tick;
+	/** Reference points to measure the jitter with sub-tick resolution */
+	uint32_t base_tick;
+	uint32_t base_uptime_us;
+
+	/** Number of activations */
+	unsigned int activations;
+	/** Number of periods that expired before the job completed */
+	unsigned int overruns;
+
+	/** Delay from the nominal release to the activation, in microseconds */
+	uint32_t last_jitter_us;
+	uint32_t min_jitter_us;
+	uint32_t max_jitter_us;
+	uint64_t total_jitter_us;
+
+} periodic_t;
+
+/** Creates the rate monotonic period of the calling task */
+rtems_status_code periodic_create(periodic_t * periodic, rtems_name name,
+		rtems_interval period);
+
+/**
+ * Blocks the calling task until the start of its next period. The first
+ * call starts the periodic activation. If the previous period expired
+ * before the call, the overrun is counted and the task is released at
+ * once, starting a new period.
+ */
+void periodic_wait(periodic_t * periodic);
+
+/**
+ * Logs the activation statistics of a periodic task with LOG_TIME, so that
+ * the report does not delay the task. The name must be a constant string.
+ */
+void periodic_report(const char * name, const periodic_t * periodic);
+
+#endif // __PERIODIC_H__
@@ -21,8 +21,16 @@
 
 #include <rtems.h>
 
+#include <cpu_usage.h>
+
 rtems_task Init(rtems_task_argument arg);
 
+/**
+ * Uncomment to run the event bus in deferred mode: producers only signal
+ * the bus task, which signals the subscribers later on.
+ */
+// #define DEFERRED_EVENT_BUS
+
 /** Definition of the Console Driver */
 #define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
 
@@ -39,7 +47,14 @@ rtems_task Init(rtems_task_argument arg);
 #define CONFIGURE_MAXIMUM_SEMAPHORES (0)
 
 /** Maximum number of tasks */
-#define CONFIGURE_MAXIMUM_TASKS      (4)
+#ifdef DEFERRED_EVENT_BUS
+#define CONFIGURE_MAXIMUM_TASKS      (8)
+#else
+#define CONFIGURE_MAXIMUM_TASKS      (7)
+#endif
+
+/** Maximum number of rate monotonic periods */
+#define CONFIGURE_MAXIMUM_PERIODS (2)
 
 /**
  * Extra stack memory needed for the tasks. It must include all the memory
@@ -58,6 +73,9 @@ rtems_task Init(rtems_task_argument arg);
                                            RTEMS_NO_TIMESLICE | \
                                            RTEMS_INTERRUPT_LEVEL(0))
 
+/** Per task CPU usage accounting */
+#define CONFIGURE_INITIAL_EXTENSIONS CPU_USAGE_EXTENSION
+
 /** Ensure that the default initialization table is defined */
 #define CONFIGURE_RTEMS_INIT_TASKS_TABLE
 
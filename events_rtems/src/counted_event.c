@@ -0,0 +1,137 @@
+/*
+ * Counted events. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <counted_event.h>
+
+static uint32_t counted_event_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+void counted_event_receiver_init(counted_event_receiver_t * receiver,
+		rtems_id task)
+{
+	int i;
+
+	receiver->task = task;
+	for (i = 0; i < 32; i++)
+	{
+		receiver->counts[i] = 0;
+		receiver->stamps_us[i] = 0;
+	}
+}
+
+rtems_status_code counted_event_send(counted_event_receiver_t * receiver,
+		rtems_event_set events)
+{
+	return counted_event_post(receiver, events, 1, counted_event_uptime_us());
+}
+
+rtems_status_code counted_event_post(counted_event_receiver_t * receiver,
+		rtems_event_set events, uint32_t count, uint32_t stamp_us)
+{
+	rtems_interrupt_level level;
+	rtems_event_set transitions = 0;
+	rtems_event_set pending = events;
+	int n;
+
+	if (count == 0)
+	{
+		return RTEMS_SUCCESSFUL;
+	}
+
+	while (pending != 0)
+	{
+		n = __builtin_ctz(pending);
+		pending &= pending - 1;
+
+		rtems_interrupt_disable(level);
+		if (receiver->counts[n] == 0)
+		{
+			transitions |= (1U << n);
+		}
+		receiver->counts[n] += count;
+		receiver->stamps_us[n] = stamp_us;
+		rtems_interrupt_enable(level);
+	}
+
+	if (transitions == 0)
+	{
+		return RTEMS_SUCCESSFUL;
+	}
+
+	return rtems_event_send(receiver->task, transitions);
+}
+
+rtems_status_code counted_event_receive(counted_event_receiver_t * receiver,
+		rtems_event_set event_in, rtems_option option_set,
+		rtems_interval ticks, uint32_t counts[32], uint32_t stamps_us[32],
+		rtems_event_set * event_out)
+{
+	rtems_interrupt_level level;
+	rtems_status_code status;
+	rtems_event_set received;
+	int n;
+
+	status = rtems_event_receive(event_in, option_set, ticks, &received);
+
+	*event_out = 0;
+	for (n = 0; n < 32; n++)
+	{
+		counts[n] = 0;
+	}
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	// Take all the counts of the requested events in one step. Counts of
+	// events sent after the receive are taken too: their bits stay pending
+	// and will come back later with a count of 0.
+	rtems_interrupt_disable(level);
+	for (n = 0; n < 32; n++)
+	{
+		if (event_in & (1U << n))
+		{
+			counts[n] = receiver->counts[n];
+			receiver->counts[n] = 0;
+			if (stamps_us != NULL)
+			{
+				stamps_us[n] = receiver->stamps_us[n];
+			}
+		}
+	}
+	rtems_interrupt_enable(level);
+
+	for (n = 0; n < 32; n++)
+	{
+		if (counts[n] != 0)
+		{
+			*event_out |= (1U << n);
+		}
+	}
+
+	return RTEMS_SUCCESSFUL;
+}
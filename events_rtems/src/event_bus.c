@@ -0,0 +1,163 @@
+/*
+ * Publish/subscribe event bus. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <event_bus.h>
+
+void event_bus_init(event_bus_t * bus)
+{
+	int i;
+
+	bus->subscriber_count = 0;
+	for (i = 0; i < 32; i++)
+	{
+		bus->topic_subscribers[i] = 0;
+	}
+	bus->topics = 0;
+	bus->deferred = 0;
+}
+
+rtems_status_code event_bus_subscribe(event_bus_t * bus,
+		counted_event_receiver_t * receiver, rtems_event_set topics)
+{
+	rtems_event_set pending = topics;
+	unsigned int s;
+
+	for (s = 0; s < bus->subscriber_count; s++)
+	{
+		if (bus->subscribers[s] == receiver)
+		{
+			break;
+		}
+	}
+
+	if (s == bus->subscriber_count)
+	{
+		if (s >= EVENT_BUS_MAX_SUBSCRIBERS)
+		{
+			return RTEMS_TOO_MANY;
+		}
+		bus->subscribers[s] = receiver;
+		bus->subscriber_topics[s] = 0;
+		bus->subscriber_count++;
+	}
+
+	bus->subscriber_topics[s] |= topics;
+	bus->topics |= topics;
+
+	while (pending != 0)
+	{
+		bus->topic_subscribers[__builtin_ctz(pending)] |= (1U << s);
+		pending &= pending - 1;
+	}
+
+	return RTEMS_SUCCESSFUL;
+}
+
+/** Signals the subscribers of the given topics */
+static void event_bus_fan_out(event_bus_t * bus, rtems_event_set topics)
+{
+	rtems_event_set pending = topics & bus->topics;
+	uint32_t subscribers = 0;
+	int s;
+
+	// Merge the subscribers of all the topics, so that each of them is
+	// signaled only once
+	while (pending != 0)
+	{
+		subscribers |= bus->topic_subscribers[__builtin_ctz(pending)];
+		pending &= pending - 1;
+	}
+
+	while (subscribers != 0)
+	{
+		s = __builtin_ctz(subscribers);
+		subscribers &= subscribers - 1;
+
+		counted_event_send(bus->subscribers[s], topics & bus->subscriber_topics[s]);
+	}
+}
+
+rtems_status_code event_bus_publish(event_bus_t * bus, rtems_event_set topics)
+{
+	if (bus->deferred)
+	{
+		return counted_event_send(&bus->task_events, topics);
+	}
+
+	event_bus_fan_out(bus, topics);
+
+	return RTEMS_SUCCESSFUL;
+}
+
+static rtems_task event_bus_task(rtems_task_argument argument)
+{
+	event_bus_t * bus = (event_bus_t *) argument;
+	rtems_event_set events, pending;
+	uint32_t counts[32];
+	uint32_t stamps_us[32];
+	uint32_t subscribers;
+	int n, s;
+
+	for (;;)
+	{
+		counted_event_receive(&bus->task_events, bus->topics,
+				RTEMS_WAIT | RTEMS_EVENT_ANY, RTEMS_NO_TIMEOUT,
+				counts, stamps_us, &events);
+
+		// Forward each topic with its count and the time it was published
+		pending = events;
+		while (pending != 0)
+		{
+			n = __builtin_ctz(pending);
+			pending &= pending - 1;
+
+			subscribers = bus->topic_subscribers[n];
+			while (subscribers != 0)
+			{
+				s = __builtin_ctz(subscribers);
+				subscribers &= subscribers - 1;
+
+				counted_event_post(bus->subscribers[s], 1U << n, counts[n],
+						stamps_us[n]);
+			}
+		}
+	}
+}
+
+rtems_status_code event_bus_start_deferred(event_bus_t * bus, rtems_name name,
+		rtems_task_priority priority)
+{
+	rtems_status_code status;
+
+	status = rtems_task_create(name, priority, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &bus->task_id);
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	counted_event_receiver_init(&bus->task_events, bus->task_id);
+	bus->deferred = 1;
+
+	return rtems_task_start(bus->task_id, event_bus_task,
+			(rtems_task_argument) bus);
+}
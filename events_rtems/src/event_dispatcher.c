@@ -0,0 +1,94 @@
+/*
+ * Event dispatcher. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <event_dispatcher.h>
+
+void event_dispatcher_init(event_dispatcher_t * dispatcher)
+{
+	int i;
+
+	for (i = 0; i < 32; i++)
+	{
+		dispatcher->entries[i].name = NULL;
+		dispatcher->entries[i].handler = NULL;
+		dispatcher->entries[i].arg = NULL;
+	}
+	dispatcher->mask = 0;
+}
+
+rtems_status_code event_dispatcher_register(event_dispatcher_t * dispatcher,
+		rtems_event_set event, const char * name, event_handler_t handler,
+		void * arg)
+{
+	event_dispatcher_entry_t * entry;
+
+	if (event == 0 || (event & (event - 1)) != 0)
+	{
+		return RTEMS_INVALID_NUMBER;
+	}
+
+	if (dispatcher->mask & event)
+	{
+		return RTEMS_RESOURCE_IN_USE;
+	}
+
+	entry = &dispatcher->entries[__builtin_ctz(event)];
+	entry->name = name;
+	entry->handler = handler;
+	entry->arg = arg;
+
+	dispatcher->mask |= event;
+
+	return RTEMS_SUCCESSFUL;
+}
+
+rtems_event_set event_dispatcher_mask(const event_dispatcher_t * dispatcher)
+{
+	return dispatcher->mask;
+}
+
+const char * event_dispatcher_name(const event_dispatcher_t * dispatcher,
+		rtems_event_set event)
+{
+	if (event == 0 || (dispatcher->mask & event) == 0)
+	{
+		return NULL;
+	}
+
+	return dispatcher->entries[__builtin_ctz(event)].name;
+}
+
+void event_dispatcher_dispatch(const event_dispatcher_t * dispatcher,
+		rtems_event_set events, const uint32_t counts[32],
+		const uint32_t stamps_us[32])
+{
+	rtems_event_set pending = events & dispatcher->mask;
+	const event_dispatcher_entry_t * entry;
+	int n;
+
+	while (pending != 0)
+	{
+		n = __builtin_ctz(pending);
+		pending &= pending - 1;
+
+		entry = &dispatcher->entries[n];
+		entry->handler(1U << n, counts[n], stamps_us[n], entry->arg);
+	}
+}
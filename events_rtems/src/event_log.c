@@ -0,0 +1,158 @@
+/*
+ * Event log ring buffer. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <event_log.h>
+
+/** Compiler barrier: the record must be complete before it is published */
+#define EVENT_LOG_BARRIER() __asm__ __volatile__ ("" : : : "memory")
+
+static event_log_record_t event_log_records[EVENT_LOG_SIZE];
+
+/** Next record to write, only modified by the writer */
+static volatile unsigned int event_log_head = 0;
+
+/** Next record to print, only modified by the dump task */
+static volatile unsigned int event_log_tail = 0;
+
+/** Records dropped because the log was full, only modified by the writer */
+static volatile unsigned int event_log_dropped = 0;
+
+/** Dropped records already reported, only modified by the dump task */
+static unsigned int event_log_reported = 0;
+
+/** Sequence number of the next record */
+static uint32_t event_log_sequence = 0;
+
+static const char * event_log_names[32];
+
+static rtems_id event_log_dump_id;
+
+void event_log_set_name(rtems_event_set event, const char * name)
+{
+	if (event != 0)
+	{
+		event_log_names[__builtin_ctz(event)] = name;
+	}
+}
+
+void event_log_write(rtems_id source, rtems_event_set event)
+{
+	unsigned int head = event_log_head;
+	event_log_record_t * record;
+
+	if (head - event_log_tail >= EVENT_LOG_SIZE)
+	{
+		event_log_dropped++;
+		event_log_sequence++;
+		return;
+	}
+
+	record = &event_log_records[head & (EVENT_LOG_SIZE - 1)];
+
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &record->tick);
+	record->source = source;
+	record->event = __builtin_ctz(event);
+	record->sequence = event_log_sequence++;
+
+	EVENT_LOG_BARRIER();
+	event_log_head = head + 1;
+}
+
+void event_log_request_dump(void)
+{
+	rtems_event_send(event_log_dump_id, EVENT_LOG_DUMP_REQUEST);
+}
+
+unsigned int event_log_dump(void)
+{
+	unsigned int tail = event_log_tail;
+	unsigned int head = event_log_head;
+	unsigned int dropped = event_log_dropped;
+	unsigned int count = 0;
+	event_log_record_t * record;
+
+	EVENT_LOG_BARRIER();
+
+	for (; tail != head; tail++, count++)
+	{
+		record = &event_log_records[tail & (EVENT_LOG_SIZE - 1)];
+
+		if (event_log_names[record->event] != NULL)
+		{
+			printf("%lu: #%lu %s from 0x%08lX\n",
+					(unsigned long) record->tick,
+					(unsigned long) record->sequence,
+					event_log_names[record->event],
+					(unsigned long) record->source);
+		}
+		else
+		{
+			printf("%lu: #%lu EVENT_%lu from 0x%08lX\n",
+					(unsigned long) record->tick,
+					(unsigned long) record->sequence,
+					(unsigned long) record->event,
+					(unsigned long) record->source);
+		}
+
+		EVENT_LOG_BARRIER();
+		event_log_tail = tail + 1;
+	}
+
+	if (dropped != event_log_reported)
+	{
+		printf("EVENT LOG: %u records dropped\n", dropped - event_log_reported);
+		event_log_reported = dropped;
+	}
+
+	return count;
+}
+
+static rtems_task event_log_dump_task(rtems_task_argument argument)
+{
+	rtems_event_set events;
+
+	for (;;)
+	{
+		// Dump on request, or when the system has been idle long enough
+		// for this low priority task to run
+		rtems_event_receive(EVENT_LOG_DUMP_REQUEST, RTEMS_WAIT | RTEMS_EVENT_ANY,
+				EVENT_LOG_IDLE_PERIOD, &events);
+
+		event_log_dump();
+	}
+}
+
+rtems_status_code event_log_init(void)
+{
+	rtems_status_code status;
+
+	status = rtems_task_create(rtems_build_name('E', 'L', 'O', 'G'),
+			EVENT_LOG_DUMP_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &event_log_dump_id);
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_task_start(event_log_dump_id, event_log_dump_task, 0);
+}
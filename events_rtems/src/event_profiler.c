@@ -0,0 +1,264 @@
+/*
+ * Event activity profiler. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <async_log.h>
+#include <event_profiler.h>
+
+static event_profiler_activity_t event_profiler_activities[EVENT_PROFILER_MAX_ACTIVITIES];
+
+static unsigned int event_profiler_count = 0;
+
+static void event_profiler_stats_init(event_profiler_stats_t * stats)
+{
+	int i;
+
+	stats->samples = 0;
+	stats->min_us = 0xFFFFFFFF;
+	stats->max_us = 0;
+	stats->total_us = 0;
+	for (i = 0; i < EVENT_PROFILER_BUCKETS; i++)
+	{
+		stats->histogram[i] = 0;
+	}
+}
+
+static void event_profiler_stats_add(event_profiler_stats_t * stats,
+		uint32_t bucket_us, uint32_t sample_us)
+{
+	uint32_t bucket = sample_us / bucket_us;
+
+	if (bucket >= EVENT_PROFILER_BUCKETS)
+	{
+		bucket = EVENT_PROFILER_BUCKETS - 1;
+	}
+
+	stats->samples++;
+	stats->total_us += sample_us;
+	stats->histogram[bucket]++;
+	if (sample_us < stats->min_us)
+	{
+		stats->min_us = sample_us;
+	}
+	if (sample_us > stats->max_us)
+	{
+		stats->max_us = sample_us;
+	}
+}
+
+/** Upper bound of the 99th percentile, from the histogram */
+static uint32_t event_profiler_stats_p99(const event_profiler_stats_t * stats,
+		uint32_t bucket_us)
+{
+	uint32_t target = (stats->samples * 99 + 99) / 100;
+	uint32_t accumulated = 0;
+	uint32_t bound;
+	int i;
+
+	for (i = 0; i < EVENT_PROFILER_BUCKETS - 1; i++)
+	{
+		accumulated += stats->histogram[i];
+		if (accumulated >= target)
+		{
+			bound = (i + 1) * bucket_us;
+			return (bound < stats->max_us) ? bound : stats->max_us;
+		}
+	}
+
+	return stats->max_us;
+}
+
+rtems_status_code event_profiler_register(const char * name,
+		rtems_event_set start_event, rtems_event_set end_event,
+		rtems_interval period)
+{
+	event_profiler_activity_t * activity;
+
+	if (event_profiler_count >= EVENT_PROFILER_MAX_ACTIVITIES)
+	{
+		return RTEMS_TOO_MANY;
+	}
+
+	activity = &event_profiler_activities[event_profiler_count];
+
+	activity->name = name;
+	activity->start_event = start_event;
+	activity->end_event = end_event;
+	activity->period_us = period * rtems_configuration_get_microseconds_per_tick();
+	activity->bucket_us = activity->period_us / EVENT_PROFILER_BUCKETS;
+	if (activity->bucket_us == 0)
+	{
+		activity->bucket_us = 1;
+	}
+	activity->started = 0;
+	activity->synchronized = 0;
+	activity->jobs = 0;
+	activity->overruns = 0;
+	activity->unpaired = 0;
+	event_profiler_stats_init(&activity->execution);
+	event_profiler_stats_init(&activity->response);
+
+	event_profiler_count++;
+
+	return RTEMS_SUCCESSFUL;
+}
+
+static void event_profiler_start(event_profiler_activity_t * activity,
+		uint32_t stamp_us)
+{
+	uint32_t expected_us = activity->release_us + activity->period_us;
+	int32_t delay_us = (int32_t)(stamp_us - expected_us);
+
+	if (activity->started)
+	{
+		// The previous job never signaled its end
+		activity->unpaired++;
+	}
+
+	if (!activity->synchronized)
+	{
+		activity->release_us = stamp_us;
+		activity->synchronized = 1;
+	}
+	else if (delay_us < 0)
+	{
+		// Earlier than the estimation: the phase of the task is earlier
+		activity->release_us = stamp_us;
+	}
+	else
+	{
+		// A late job keeps its nominal release, whole periods later
+		while (delay_us >= (int32_t) activity->period_us)
+		{
+			expected_us += activity->period_us;
+			delay_us -= activity->period_us;
+			activity->overruns++;
+		}
+		activity->release_us = expected_us;
+	}
+
+	activity->started = 1;
+	activity->start_us = stamp_us;
+}
+
+static void event_profiler_end(event_profiler_activity_t * activity,
+		uint32_t stamp_us)
+{
+	if (!activity->started)
+	{
+		activity->unpaired++;
+		return;
+	}
+
+	activity->started = 0;
+	activity->jobs++;
+
+	event_profiler_stats_add(&activity->execution, activity->bucket_us,
+			stamp_us - activity->start_us);
+	event_profiler_stats_add(&activity->response, activity->bucket_us,
+			stamp_us - activity->release_us);
+
+	if ((activity->jobs % EVENT_PROFILER_REPORT_JOBS) == 0)
+	{
+		event_profiler_report(activity);
+	}
+}
+
+void event_profiler_process(rtems_event_set events, const uint32_t counts[32],
+		const uint32_t stamps_us[32])
+{
+	event_profiler_activity_t * activity;
+	uint32_t start_count, end_count, start_us, end_us;
+	unsigned int i;
+
+	for (i = 0; i < event_profiler_count; i++)
+	{
+		activity = &event_profiler_activities[i];
+
+		start_count = (events & activity->start_event) ?
+				counts[__builtin_ctz(activity->start_event)] : 0;
+		end_count = (events & activity->end_event) ?
+				counts[__builtin_ctz(activity->end_event)] : 0;
+
+		if (start_count == 0 && end_count == 0)
+		{
+			continue;
+		}
+
+		// Only the last occurrence of each event has a time stamp
+		if (start_count > 1)
+		{
+			activity->unpaired += start_count - 1;
+		}
+		if (end_count > 1)
+		{
+			activity->unpaired += end_count - 1;
+		}
+
+		start_us = stamps_us[__builtin_ctz(activity->start_event)];
+		end_us = stamps_us[__builtin_ctz(activity->end_event)];
+
+		if (start_count == 0)
+		{
+			event_profiler_end(activity, end_us);
+		}
+		else if (end_count == 0)
+		{
+			event_profiler_start(activity, start_us);
+		}
+		else if ((int32_t)(end_us - start_us) < 0)
+		{
+			// The end belongs to the previous job
+			event_profiler_end(activity, end_us);
+			event_profiler_start(activity, start_us);
+		}
+		else
+		{
+			event_profiler_start(activity, start_us);
+			event_profiler_end(activity, end_us);
+		}
+	}
+}
+
+void event_profiler_report(const event_profiler_activity_t * activity)
+{
+	const event_profiler_stats_t * execution = &activity->execution;
+	const event_profiler_stats_t * response = &activity->response;
+
+	if (execution->samples == 0)
+	{
+		return;
+	}
+
+	LOG_TIME("%s profile: %lu jobs, %lu overruns, %lu unpaired events\n",
+			activity->name,
+			(unsigned long) activity->jobs,
+			(unsigned long) activity->overruns,
+			(unsigned long) activity->unpaired);
+	LOG_TIME("  exec us min %lu mean %lu p99 %lu max %lu\n",
+			(unsigned long) execution->min_us,
+			(unsigned long)(execution->total_us / execution->samples),
+			(unsigned long) event_profiler_stats_p99(execution, activity->bucket_us),
+			(unsigned long) execution->max_us);
+	LOG_TIME("  resp us min %lu mean %lu p99 %lu max %lu\n",
+			(unsigned long) response->min_us,
+			(unsigned long)(response->total_us / response->samples),
+			(unsigned long) event_profiler_stats_p99(response, activity->bucket_us),
+			(unsigned long) response->max_us);
+}
@@ -24,16 +24,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <async_log.h>
+
 #define PRINT(fmt,args...)  printf ( fmt "\n",\
                             ##args)
 
-#define PRINT_TIME(fmt,args...) do { \
-			unsigned int __current_tick; \
-			rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &__current_tick); \
-			printf ("%lu: " fmt "\n", __current_tick, ##args); \
-			} while (0)
+#define PRINT_TIME(fmt,args...) LOG_TIME(fmt "\n", ##args)
 
 #include <consume_ticks.h>
+#include <periodic.h>
+#include <event_log.h>
+#include <counted_event.h>
+#include <event_profiler.h>
+#include <event_dispatcher.h>
+#include <event_bus.h>
 
 /** Events to be logged */
 #define EVENT_ACS_START 	RTEMS_EVENT_0
@@ -41,55 +45,102 @@
 #define EVENT_HK_START 		RTEMS_EVENT_2
 #define EVENT_HK_END		RTEMS_EVENT_3
 
+/** Period of the housekeeping task, in ticks */
+#define HK_PERIOD	12
+
+/** Period of the ACS task, in ticks */
+#define ACS_PERIOD	140
+
+/** Priority of the event bus task in deferred mode, the one of the producers */
+#define EVENT_BUS_PRIORITY	10
+
+/** Number of activations between two periodic statistics reports */
+#define PERIODIC_REPORT_ACTIVATIONS	100
+
+/**
+ * Profiler mode: the logging server also measures the execution and
+ * response times of the HK and ACS activities. Comment out to only log
+ * the events.
+ */
+#define PROFILE_ACTIVITIES
+
 /** Logging Server Task ID */
 rtems_id logging_server_id;
 
+/** Event bus between the producers and their consumers */
+event_bus_t event_bus;
+
+/** Counted events of the logging server */
+counted_event_receiver_t logging_server_events;
+
+/** Events handled by the logging server */
+event_dispatcher_t logging_server_dispatcher;
+
 /** Housekeeping Task ID */
 rtems_id housekeeping_task_id;
 
 /** ACS Task ID */
 rtems_id acs_task_id;
 
+/**
+ * Event handler of the logging server: stores each occurrence of the event
+ * in the event log. arg points to the ID of the task that signals it.
+ */
+void log_event(rtems_event_set event, uint32_t count, uint32_t stamp_us,
+		void * arg)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		event_log_write(*(rtems_id *) arg, event);
+	}
+}
+
+/** Registers an event handled by the logging server */
+void register_logged_event(rtems_event_set event, const char * name,
+		rtems_id * source)
+{
+	event_dispatcher_register(&logging_server_dispatcher, event, name,
+			log_event, source);
+	event_log_set_name(event, name);
+}
+
 /**
  * Logging server task.
  *
  * This task must implement an infinite loop that does the following:
  *
- * 1) waits for the occurrence of an event.
- * 2) prints the time and the event type on screen, emulating the log
+ * 1) waits for the occurrence of any of the registered events.
+ * 2) dispatches each event to its handler, which stores the time, the
+ *    source and the event type in the event log, printed later on by its
+ *    dump task
+ * 3) in profiler mode, feeds the activity profiler with the time stamps of
+ *    the events
  */
 rtems_task logging_server(rtems_task_argument argument)
 {
 	rtems_event_set event_out;
+	uint32_t counts[32];
+	uint32_t stamps_us[32];
+	rtems_event_set event_in = event_dispatcher_mask(&logging_server_dispatcher);
 
 	for (;;)
 	{
 
 		// TODO: Wait for any of the events defined
 		//	ESPERA BLOQUEANTE HASTA QUE LLEGUE ALGUN EVENTO
-		rtems_event_receive(EVENT_ACS_START | EVENT_ACS_END | EVENT_HK_START | EVENT_HK_END,
-				RTEMS_WAIT|RTEMS_EVENT_ANY, RTEMS_NO_TIMEOUT, &event_out ) ;
+		counted_event_receive(&logging_server_events, event_in,
+				RTEMS_WAIT|RTEMS_EVENT_ANY, RTEMS_NO_TIMEOUT, counts, stamps_us, &event_out ) ;
 
-		//VERDADERO CUANTO EVENT_OUT TIENE 1 EN LA MISMA POSICION QUE HOUSE_KEEPING START
-		if (event_out & EVENT_HK_START){
-			PRINT_TIME("EVENT_HK_START");
+		// TODO: When an event takes place, log time and event type, once
+		// per occurrence
+		event_dispatcher_dispatch(&logging_server_dispatcher, event_out,
+				counts, stamps_us);
 
-		} ;
-		if (event_out & EVENT_HK_END){
-
-			PRINT_TIME("EVENT_HK_END");
-		} ;
-
-		if (event_out & EVENT_ACS_START){
-					PRINT_TIME("EVENT_ACS_START");
-
-				} ;
-		if (event_out & EVENT_ACS_END){
-
-					PRINT_TIME("EVENT_ACS_END");
-				} ;
-
-		// TODO: When an event takes place, print time and event type
+#ifdef PROFILE_ACTIVITIES
+		event_profiler_process(event_out, counts, stamps_us);
+#endif
 
 	}
 }
@@ -99,24 +150,32 @@ rtems_task logging_server(rtems_task_argument argument)
  *
  * This task must implement an infinite loop that does the following:
  *
- * 1) Signals the EVENT_HK_START to the logging server
- * 2) occupies the CPU for 2 ticks
- * 3) Signals the EVENT_HK_END to the logging server
- * 4) sleeps for 10 ticks
+ * 1) waits for the start of its period (HK_PERIOD ticks)
+ * 2) Signals the EVENT_HK_START to the logging server
+ * 3) occupies the CPU for 2 ticks
+ * 4) Signals the EVENT_HK_END to the logging server
  */
 rtems_task housekeeping_task(rtems_task_argument argument)
 {
+	periodic_t periodic;
+
+	periodic_create(&periodic, rtems_build_name('H', 'K', 'P', 'R'), HK_PERIOD);
 
 	for (;;)
 	{
+		// TODO: Wait until next execution
+		periodic_wait(&periodic);
+		if ((periodic.activations % PERIODIC_REPORT_ACTIVATIONS) == 0)
+		{
+			periodic_report("HK", &periodic);
+		}
+
 		// TODO: Signal the event EVENT_HK_START
-		rtems_event_send(logging_server_id, EVENT_HK_START);
+		event_bus_publish(&event_bus, EVENT_HK_START);
 		// TODO: Simulate processing
 		consume_ticks(2);
 		// TODO: Signal the event EVENT_HK_END
-		rtems_event_send(logging_server_id, EVENT_HK_END) ;
-		// TODO: Wait until next execution
-		rtems_task_wake_after(10);
+		event_bus_publish(&event_bus, EVENT_HK_END) ;
 
 	}
 }
@@ -126,26 +185,34 @@ rtems_task housekeeping_task(rtems_task_argument argument)
  *
  * This task must implement an infinite loop that does the following:
  *
- * 1) Signals the EVENT_ACS_START to the logging server
- * 2) occupies the CPU for 40 ticks
- * 3) Signals the EVENT_ACS_END to the logging server
- * 3) sleeps for 100 ticks
+ * 1) waits for the start of its period (ACS_PERIOD ticks)
+ * 2) Signals the EVENT_ACS_START to the logging server
+ * 3) occupies the CPU for 40 ticks
+ * 4) Signals the EVENT_ACS_END to the logging server
  */
 rtems_task acs_task(rtems_task_argument argument)
 {
+	periodic_t periodic;
+
+	periodic_create(&periodic, rtems_build_name('A', 'C', 'P', 'R'), ACS_PERIOD);
+
 	for (;;)
 	{
+		// TODO: Wait until next execution
+		periodic_wait(&periodic);
+		if ((periodic.activations % PERIODIC_REPORT_ACTIVATIONS) == 0)
+		{
+			periodic_report("ACS", &periodic);
+		}
+
 		// TODO: Signal the event EVENT_ACS_START
-		rtems_event_send(logging_server_id, EVENT_ACS_START);
+		event_bus_publish(&event_bus, EVENT_ACS_START);
 
 		// TODO: Simulate processing
 		consume_ticks(40);
 
 		// TODO: Signal the event EVENT_ACS_END
-		rtems_event_send(logging_server_id, EVENT_ACS_END);
-
-		// TODO: Wait until next execution
-		rtems_task_wake_after(100);
+		event_bus_publish(&event_bus, EVENT_ACS_END);
 
 	}
 }
@@ -153,6 +220,30 @@ rtems_task acs_task(rtems_task_argument argument)
 
 rtems_task Init(rtems_task_argument arg)
 {
+	// Calibrate the busy work against the clock, before any task runs
+	consume_calibrate();
+
+	// Start the asynchronous logging drain task
+	log_init(LOG_DRAIN_PRIORITY);
+
+	// Start the CPU usage reporter
+	cpu_usage_init(CPU_USAGE_REPORT_PRIORITY, CPU_USAGE_REPORT_PERIOD);
+
+	// Build the event table of the logging server
+	event_dispatcher_init(&logging_server_dispatcher);
+	register_logged_event(EVENT_ACS_START, "EVENT_ACS_START", &acs_task_id);
+	register_logged_event(EVENT_ACS_END, "EVENT_ACS_END", &acs_task_id);
+	register_logged_event(EVENT_HK_START, "EVENT_HK_START", &housekeeping_task_id);
+	register_logged_event(EVENT_HK_END, "EVENT_HK_END", &housekeeping_task_id);
+
+	// Start the event log dump task
+	event_log_init();
+
+#ifdef PROFILE_ACTIVITIES
+	event_profiler_register("HK", EVENT_HK_START, EVENT_HK_END, HK_PERIOD);
+	event_profiler_register("ACS", EVENT_ACS_START, EVENT_ACS_END, ACS_PERIOD);
+#endif
+
 	// TODO: Create Logging Server
 		rtems_task_create(rtems_build_name('T', 'S', 'K', '1'),
 		10, RTEMS_MINIMUM_STACK_SIZE,
@@ -160,8 +251,18 @@ rtems_task Init(rtems_task_argument arg)
 		RTEMS_DEFAULT_ATTRIBUTES, &logging_server_id);
 
 	// TODO: Start Logging Server
+		counted_event_receiver_init(&logging_server_events, logging_server_id);
 		rtems_task_start(logging_server_id, logging_server, 0);
 
+	// Subscribe the logging server to the events it handles
+	event_bus_init(&event_bus);
+	event_bus_subscribe(&event_bus, &logging_server_events,
+			event_dispatcher_mask(&logging_server_dispatcher));
+#ifdef DEFERRED_EVENT_BUS
+	event_bus_start_deferred(&event_bus, rtems_build_name('E', 'B', 'U', 'S'),
+			EVENT_BUS_PRIORITY);
+#endif
+
 	// TODO: Create Housekeeping task
 		rtems_task_create(rtems_build_name('T', 'S', 'K', '2'),
 		10, RTEMS_MINIMUM_STACK_SIZE,
@@ -0,0 +1,112 @@
+/*
+ * Periodic activation helper functions. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <async_log.h>
+#include <periodic.h>
+
+static uint32_t periodic_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+rtems_status_code periodic_create(periodic_t * periodic, rtems_name name,
+		rtems_interval period)
+{
+	periodic->period = period;
+	periodic->activations = 0;
+	periodic->overruns = 0;
+	periodic->last_jitter_us = 0;
+	periodic->min_jitter_us = 0xFFFFFFFF;
+	periodic->max_jitter_us = 0;
+	periodic->total_jitter_us = 0;
+
+	return rtems_rate_monotonic_create(name, &periodic->period_id);
+}
+
+void periodic_wait(periodic_t * periodic)
+{
+	rtems_status_code status;
+	uint32_t current_tick, now_us, expected_us;
+
+	status = rtems_rate_monotonic_period(periodic->period_id, periodic->period);
+
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &current_tick);
+	now_us = periodic_uptime_us();
+
+	if (periodic->activations == 0 || status == RTEMS_TIMEOUT)
+	{
+		// The period (re)starts now
+		if (status == RTEMS_TIMEOUT)
+		{
+			periodic->overruns++;
+		}
+		periodic->release_tick = current_tick;
+		periodic->base_tick = current_tick;
+		periodic->base_uptime_us = now_us;
+		periodic->last_jitter_us = 0;
+	}
+	else
+	{
+		periodic->release_tick += periodic->period;
+
+		expected_us = periodic->base_uptime_us +
+				(periodic->release_tick - periodic->base_tick) *
+				rtems_configuration_get_microseconds_per_tick();
+
+		periodic->last_jitter_us =
+				((int32_t)(now_us - expected_us) > 0) ? now_us - expected_us : 0;
+
+		if (periodic->last_jitter_us < periodic->min_jitter_us)
+		{
+			periodic->min_jitter_us = periodic->last_jitter_us;
+		}
+		if (periodic->last_jitter_us > periodic->max_jitter_us)
+		{
+			periodic->max_jitter_us = periodic->last_jitter_us;
+		}
+		periodic->total_jitter_us += periodic->last_jitter_us;
+	}
+
+	periodic->activations++;
+}
+
+void periodic_report(const char * name, const periodic_t * periodic)
+{
+	// The first activation and those after an overrun have no jitter sample
+	unsigned int samples = (periodic->activations > 1 + periodic->overruns) ?
+			periodic->activations - 1 - periodic->overruns : 0;
+
+	// A log record holds up to LOG_MAX_ARGS arguments: two records
+	LOG_TIME("%s => period %lu | activations %u | overruns %u\n",
+			name,
+			(unsigned long) periodic->period,
+			periodic->activations,
+			periodic->overruns);
+	LOG_TIME("%s => jitter us min %lu avg %lu max %lu\n",
+			name,
+			(unsigned long)((samples > 0) ? periodic->min_jitter_us : 0),
+			(unsigned long)((samples > 0) ?
+					periodic->total_jitter_us / samples : 0),
+			(unsigned long) periodic->max_jitter_us);
+}
@@ -4,16 +4,34 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/async_log.c \
 ../src/consume_ticks.c \
-../src/main.c 
+../src/cpu_usage.c \
+../src/main.c \
+../src/periodic.c \
+../src/tm_bench.c \
+../src/tm_codec.c \
+../src/tm_producer.c 
 
 OBJS += \
+./src/async_log.o \
 ./src/consume_ticks.o \
-./src/main.o 
+./src/cpu_usage.o \
+./src/main.o \
+./src/periodic.o \
+./src/tm_bench.o \
+./src/tm_codec.o \
+./src/tm_producer.o 
 
 C_DEPS += \
+./src/async_log.d \
 ./src/consume_ticks.d \
-./src/main.d 
+./src/cpu_usage.d \
+./src/main.d \
+./src/periodic.d \
+./src/tm_bench.d \
+./src/tm_codec.d \
+./src/tm_producer.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
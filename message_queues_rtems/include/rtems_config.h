@@ -21,8 +21,18 @@
 
 #include <rtems.h>
 
+#include <cpu_usage.h>
+
+#include <telemetry.h>
+
 rtems_task Init(rtems_task_argument arg);
 
+/**
+ * Uncomment to run the telemetry server scalability benchmark (1 to
+ * TM_BENCH_MAX_WORKERS workers) instead of the demo.
+ */
+// #define TM_BENCHMARK
+
 /** Definition of the Console Driver */
 #define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
 
@@ -35,15 +45,30 @@ rtems_task Init(rtems_task_argument arg);
 /** Default value of ticks per timeslice */
 #define CONFIGURE_TICKS_PER_TIMESLICE (50)
 
-/** Maximum number of semaphores */
+/** Maximum number of semaphores: the free slots of the benchmark queues */
+#ifdef TM_BENCHMARK
+#define CONFIGURE_MAXIMUM_SEMAPHORES (TM_BENCH_MAX_WORKERS)
+#else
 #define CONFIGURE_MAXIMUM_SEMAPHORES (0)
+#endif
 
 // TODO: Define maximum number of tasks
-#define CONFIGURE_MAXIMUM_TASKS (4)
+#ifdef TM_BENCHMARK
+#define CONFIGURE_MAXIMUM_TASKS (4 + TM_BENCH_MAX_WORKERS)
+#else
+#define CONFIGURE_MAXIMUM_TASKS (5 + TM_SERVER_WORKERS)
+#endif
 
 
 // TODO: Define maximum number of message queues
-#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES (1)
+#ifdef TM_BENCHMARK
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES (TM_BENCH_MAX_WORKERS)
+#else
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES (TM_SERVER_WORKERS)
+#endif
+/** Maximum number of rate monotonic periods */
+#define CONFIGURE_MAXIMUM_PERIODS (2)
+
 /**
  * Extra stack memory needed for the tasks. It must include all the memory
  * of the different tasks that exceeds of 4KiB per task.
@@ -61,6 +86,9 @@ rtems_task Init(rtems_task_argument arg);
                                            RTEMS_NO_TIMESLICE | \
                                            RTEMS_INTERRUPT_LEVEL(0))
 
+/** Per task CPU usage accounting */
+#define CONFIGURE_INITIAL_EXTENSIONS CPU_USAGE_EXTENSION
+
 /** Ensure that the default initialization table is defined */
 #define CONFIGURE_RTEMS_INIT_TASKS_TABLE
 
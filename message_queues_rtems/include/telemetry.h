@@ -0,0 +1,60 @@
+/*
+ * Telemetry record definition. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <rtems.h>
+#include <stddef.h>
+
+/**
+ * Number of telemetry server workers. Each worker has its own message
+ * queue, and the senders are distributed among them.
+ */
+#define TM_SERVER_WORKERS (1)
+
+/** Maximum number of workers of the telemetry server benchmark */
+#define TM_BENCH_MAX_WORKERS (4)
+
+/** Maximum size of a telemetry payload */
+#define TM_MAX_DATA_SIZE 20
+
+/**
+ * Telemetry record. Only the header and the first data_size bytes of the
+ * data buffer are copied through the message queue, the payload is NOT
+ * NUL-terminated.
+ */
+typedef struct {
+
+	/** Sender Task ID */
+	rtems_id sender_id;
+	/** Telemetry Frame Counter */
+	unsigned int counter;
+	/** Data size */
+	unsigned short data_size;
+	/** Telemetries of the sender lost just before this one */
+	unsigned short lost;
+	/** Data buffer */
+	char data[TM_MAX_DATA_SIZE];
+
+} telemetry_t;
+
+/** Number of bytes of a telemetry record carrying data_size bytes of data */
+#define TM_MESSAGE_SIZE(data_size) (offsetof(telemetry_t, data) + (data_size))
+
+#endif // __TELEMETRY_H__
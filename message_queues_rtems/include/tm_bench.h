@@ -0,0 +1,29 @@
+/*
+ * Telemetry server scalability benchmark. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TM_BENCH_H__
+#define __TM_BENCH_H__
+
+/**
+ * Runs the telemetry server benchmark with 1 to TM_BENCH_MAX_WORKERS
+ * workers, prints the throughput of each configuration and shuts the
+ * system down. It must be called from the Init task.
+ */
+void tm_benchmark(void);
+
+#endif // __TM_BENCH_H__
@@ -0,0 +1,128 @@
+/*
+ * Telemetry downlink frame codec. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TM_CODEC_H__
+#define __TM_CODEC_H__
+
+#include <telemetry.h>
+
+/**
+ * Downlink frame layout:
+ *
+ *   +------+------+--------+-------------+
+ *   | 0xEB | 0x90 | length | records ... |
+ *   +------+------+--------+-------------+
+ *
+ * where length is the number of bytes of records (16 bits, big endian).
+ * Each record starts with a tag byte whose two upper bits give the record
+ * type and whose lower six bits give the sender index:
+ *
+ *   TM_REC_FULL:   tag, counter (varint), data_size (1 byte), data
+ *   TM_REC_REPEAT: tag, counter delta (varint)
+ *                  same payload as the previous record of the sender
+ *   TM_REC_RUN:    tag, n (1 byte)
+ *                  n telemetries with the same payload as the previous
+ *                  record of the sender, counters incremented by one
+ *   TM_REC_LOST:   tag, n (varint)
+ *                  n telemetries of the sender were lost on board just
+ *                  before its next record
+ *
+ * The dictionary of previous payloads is reset at the start of every
+ * frame, so each frame can be decoded on its own. The order of the
+ * telemetries of each sender is kept, but a run may absorb telemetries
+ * received after records of other senders.
+ */
+
+#define TM_FRAME_SYNC_0		0xEB
+#define TM_FRAME_SYNC_1		0x90
+#define TM_FRAME_HEADER_SIZE	4
+
+#define TM_REC_FULL		0x00
+#define TM_REC_REPEAT		0x40
+#define TM_REC_RUN		0x80
+#define TM_REC_LOST		0xC0
+#define TM_REC_TYPE_MASK	0xC0
+#define TM_REC_SENDER_MASK	0x3F
+
+/** Maximum number of registered senders */
+#define TM_CODEC_MAX_SENDERS	4
+
+/** Maximum size of an encoded downlink frame */
+#define TM_FRAME_MAX_SIZE	256
+
+/** Worst-case size of a single encoded record */
+#define TM_REC_MAX_SIZE		((1 + 5) + (1 + 5 + 1 + TM_MAX_DATA_SIZE))
+
+/** Last payload sent by a sender within the current frame */
+typedef struct {
+
+	/** Set if the entry holds a payload */
+	int valid;
+	/** Counter of the last telemetry */
+	unsigned int counter;
+	/** Data size */
+	unsigned int data_size;
+	/** Data buffer */
+	char data[TM_MAX_DATA_SIZE];
+	/** Offset of the last RUN record of the sender, -1 if none */
+	int run_offset;
+
+} tm_codec_entry_t;
+
+typedef struct {
+
+	/** Encoded frame, including the header */
+	unsigned char buffer[TM_FRAME_MAX_SIZE];
+	/** Number of used bytes of the buffer */
+	unsigned int size;
+	/** Number of telemetries aggregated into the frame */
+	unsigned int telemetries;
+	/** Bytes these telemetries take as individual queue records */
+	unsigned int raw_size;
+	/** Per-sender dictionary */
+	tm_codec_entry_t entries[TM_CODEC_MAX_SENDERS];
+
+} tm_frame_t;
+
+/**
+ * Registers a sender. Senders must be registered before their first
+ * telemetry is added to a frame. The sender index is the order of
+ * registration. Returns the index, or -1 if the table is full.
+ */
+int tm_codec_register_sender(rtems_id sender_id);
+
+/** Empties a frame and its dictionary */
+void tm_frame_reset(tm_frame_t * frame);
+
+/**
+ * Encodes a telemetry into a frame. Returns 0 on success, or -1 if the
+ * frame has no room left for a worst-case record (the frame must be
+ * sent and reset) or if the sender is not registered.
+ */
+int tm_frame_add(tm_frame_t * frame, const telemetry_t * tm);
+
+/** Returns non-zero if the frame holds no telemetry */
+int tm_frame_is_empty(const tm_frame_t * frame);
+
+/**
+ * Completes the header of the frame. Returns the total number of bytes of
+ * the frame to be sent.
+ */
+unsigned int tm_frame_close(tm_frame_t * frame);
+
+#endif // __TM_CODEC_H__
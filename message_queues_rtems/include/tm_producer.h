@@ -0,0 +1,90 @@
+/*
+ * Telemetry producer overflow policies. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TM_PRODUCER_H__
+#define __TM_PRODUCER_H__
+
+#include <rtems.h>
+
+#include <telemetry.h>
+
+/** What to do with a telemetry when the message queue is full */
+typedef enum {
+
+	/** The new telemetry is discarded */
+	TM_OVERFLOW_DROP_NEWEST,
+	/**
+	 * The oldest pending telemetry is removed from the queue, whatever its
+	 * sender, to make room for the new one
+	 */
+	TM_OVERFLOW_DROP_OLDEST,
+	/**
+	 * The new telemetry is discarded and counted. The count is sent in the
+	 * lost field of the next telemetry that fits in the queue.
+	 */
+	TM_OVERFLOW_COALESCE,
+	/**
+	 * The producer retries once per tick until there is room in the queue
+	 * or the timeout expires, then the telemetry is discarded
+	 */
+	TM_OVERFLOW_BLOCK
+
+} tm_overflow_policy_t;
+
+typedef struct {
+
+	/** Destination message queue */
+	rtems_id queue;
+	/** Overflow policy */
+	tm_overflow_policy_t policy;
+	/** Maximum blocking time in ticks, TM_OVERFLOW_BLOCK only */
+	rtems_interval timeout;
+
+	/** Number of telemetries sent */
+	unsigned int sent;
+	/** Number of new telemetries discarded (DROP_NEWEST) */
+	unsigned int dropped_newest;
+	/** Number of queued telemetries evicted (DROP_OLDEST) */
+	unsigned int dropped_oldest;
+	/** Number of telemetries folded into a lost counter (COALESCE) */
+	unsigned int coalesced;
+	/** Number of telemetries discarded after blocking (BLOCK) */
+	unsigned int timeouts;
+	/** Number of sends that failed for any other reason */
+	unsigned int errors;
+
+	/** Coalesced telemetries not reported yet */
+	unsigned short pending_lost;
+
+} tm_producer_t;
+
+/** Initializes a producer sending to the given queue */
+void tm_producer_init(tm_producer_t * producer, rtems_id queue,
+		tm_overflow_policy_t policy, rtems_interval timeout);
+
+/**
+ * Sends a telemetry applying the overflow policy of the producer. The
+ * lost field of the telemetry is overwritten. Returns RTEMS_SUCCESSFUL if
+ * the telemetry was queued.
+ */
+rtems_status_code tm_producer_send(tm_producer_t * producer, telemetry_t * tm);
+
+/** Prints the counters of a producer */
+void tm_producer_report(const char * name, const tm_producer_t * producer);
+
+#endif // __TM_PRODUCER_H__
@@ -23,11 +23,18 @@
 /** Luckily, we have the libc! :) */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <async_log.h>
 
 #define PRINT(fmt,args...)  printf ( fmt "\n",\
                             ##args)
 
-#define PRINT_TIME(fmt,args...) do { \
+#define PRINT_TIME(fmt,args...) LOG_TIME(fmt "\n", ##args)
+
+/** Synchronous version of PRINT_TIME, for the downlink output and reports */
+#define PRINT_TIME_SYNC(fmt,args...) do { \
 			unsigned int __current_tick; \
 			rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &__current_tick); \
 			printf ("%lu: " fmt "\n", __current_tick, ##args); \
@@ -35,24 +42,42 @@
 
 #include <consume_ticks.h>
 
-typedef struct {
+#include <telemetry.h>
+#include <tm_codec.h>
+#include <tm_producer.h>
+#include <tm_bench.h>
+#include <periodic.h>
 
-	/** Sender Task ID */
-	rtems_id sender_id;
-	/** Telemetry Frame Counter */
-	unsigned int counter;
-	/** Data size */
-	unsigned int data_size;
-	/** Data buffer */
-	char data[20];
+/** Maximum number of pending telemetries per queue */
+#define TM_QUEUE_LENGTH 128
 
-} telemetry_t;
+/** Queue (and server worker) of the sender with the given codec index */
+#define TM_SERVER_SHARD(sender_index) ((sender_index) % TM_SERVER_WORKERS)
 
-/** The one and only message queue */
-rtems_id tm_message_queue;
+/**
+ * Copies a string (without the trailing NUL) into the payload of a
+ * telemetry, truncating it to TM_MAX_DATA_SIZE bytes.
+ */
+static void telemetry_set_data(telemetry_t * tm, const char * str)
+{
+	size_t size = strlen(str);
 
-/** Telemetry Server Task ID */
-rtems_id telemetry_server_id;
+	if (size > TM_MAX_DATA_SIZE)
+	{
+		size = TM_MAX_DATA_SIZE;
+	}
+	memcpy(tm->data, str, size);
+	tm->data_size = size;
+}
+
+/**
+ * Telemetry message queues, one per server worker. The telemetries of a
+ * sender always go to the same queue, so they are sent in order.
+ */
+rtems_id tm_message_queues[TM_SERVER_WORKERS];
+
+/** Telemetry Server Task IDs, one per worker */
+rtems_id telemetry_server_ids[TM_SERVER_WORKERS];
 
 /** Houskeeping Task ID */
 rtems_id housekeeping_task_id;
@@ -60,35 +85,194 @@ rtems_id housekeeping_task_id;
 /** ACS Task ID */
 rtems_id acs_task_id;
 
+/** Overflow policy of the housekeeping telemetries */
+#define HK_OVERFLOW_POLICY	TM_OVERFLOW_COALESCE
+#define HK_OVERFLOW_TIMEOUT	0
+
+/** Overflow policy of the ACS telemetries */
+#define ACS_OVERFLOW_POLICY	TM_OVERFLOW_BLOCK
+#define ACS_OVERFLOW_TIMEOUT	5
+
+/** Period of the housekeeping task, in ticks */
+#define HK_PERIOD	12
+
+/** Period of the ACS task, in ticks */
+#define ACS_PERIOD	140
+
+/** Number of activations between two periodic statistics reports */
+#define PERIODIC_REPORT_ACTIVATIONS	100
+
+/** Housekeeping telemetry producer */
+tm_producer_t housekeeping_producer;
+
+/** ACS telemetry producer */
+tm_producer_t acs_producer;
+
+/** Aggregation window of the downlink frames, in ticks */
+#define TM_AGGREGATION_WINDOW 100
+
+/** Number of frames between two downlink statistics reports */
+#define TM_STATS_REPORT_FRAMES 36
+
+/** Downlink statistics of a server worker */
+typedef struct {
+
+	/** Number of frames sent */
+	unsigned int frames;
+	/** Number of telemetries sent */
+	unsigned int telemetries;
+	/** Bytes needed to send the telemetries one by one */
+	unsigned int raw_bytes;
+	/** Bytes actually sent in aggregated frames */
+	unsigned int frame_bytes;
+
+} tm_downlink_stats_t;
+
+static tm_downlink_stats_t tm_downlink_stats[TM_SERVER_WORKERS];
+
+/** Tick of the start of the downlink measurement */
+static uint32_t tm_downlink_start_tick;
+
+/**
+ * Prints the downlink usage, extrapolated to bytes per simulated hour,
+ * with and without the aggregation stage.
+ */
+static void tm_downlink_report(void)
+{
+	uint32_t current_tick, ticks_per_second, elapsed;
+	unsigned long long ticks_per_hour;
+	tm_downlink_stats_t total = { 0, 0, 0, 0 };
+	int i;
+
+	for (i = 0; i < TM_SERVER_WORKERS; i++)
+	{
+		total.frames += tm_downlink_stats[i].frames;
+		total.telemetries += tm_downlink_stats[i].telemetries;
+		total.raw_bytes += tm_downlink_stats[i].raw_bytes;
+		total.frame_bytes += tm_downlink_stats[i].frame_bytes;
+	}
+
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &current_tick);
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_PER_SECOND, &ticks_per_second);
+
+	elapsed = current_tick - tm_downlink_start_tick;
+	if (elapsed == 0)
+	{
+		return;
+	}
+	ticks_per_hour = 3600ULL * ticks_per_second;
+
+	PRINT_TIME_SYNC("Downlink => %u TM in %u frames | raw %lu B/h | framed %lu B/h",
+			total.telemetries,
+			total.frames,
+			(unsigned long)(total.raw_bytes * ticks_per_hour / elapsed),
+			(unsigned long)(total.frame_bytes * ticks_per_hour / elapsed));
+
+	tm_producer_report("HK", &housekeeping_producer);
+	tm_producer_report("ACS", &acs_producer);
+}
+
 /**
- * Telemetry downlink server demo task.
+ * Sends a downlink frame (i.e. prints it in hexadecimal) and updates the
+ * downlink statistics.
+ */
+static void tm_downlink_send(int worker, tm_frame_t * frame)
+{
+	tm_downlink_stats_t * stats = &tm_downlink_stats[worker];
+	unsigned int size, i;
+
+	size = tm_frame_close(frame);
+
+	PRINT_TIME_SYNC("Sent TM frame => worker %d | %u TM | %u bytes (raw %u bytes)",
+			worker, frame->telemetries, size, frame->raw_size);
+	for (i = 0; i < size; i++)
+	{
+		printf("%02X", frame->buffer[i]);
+	}
+	printf("\n");
+
+	stats->frames++;
+	stats->telemetries += frame->telemetries;
+	stats->raw_bytes += frame->raw_size;
+	stats->frame_bytes += size;
+
+	if ((stats->frames % TM_STATS_REPORT_FRAMES) == 0)
+	{
+		tm_downlink_report();
+	}
+
+	tm_frame_reset(frame);
+}
+
+/**
+ * Telemetry downlink server demo task. TM_SERVER_WORKERS instances run
+ * in parallel, the argument is the index of the worker and of its queue.
  *
  * This task must implement an infinite loop that does the following:
  *
  * 1) waits for an incoming message from the rest of the tasks.
- * 2) when a message arrives, it formats the message and "sends: it
- *    (i.e. it prints it).
- * 3) occupies the CPU for 1 tick
+ * 2) when a message arrives, it is encoded into the current downlink
+ *    frame and occupies the CPU for 1 tick.
+ * 3) every TM_AGGREGATION_WINDOW ticks, or when the frame is full, it
+ *    "sends" the frame (i.e. it prints it).
  */
 
 rtems_task telemetry_server(rtems_task_argument argument)
 {
+	static tm_frame_t frames[TM_SERVER_WORKERS];
+	int worker = argument;
+	tm_frame_t * frame = &frames[worker];
 	telemetry_t tm;
 	size_t size;
+	uint32_t current_tick, window_end;
+	rtems_status_code status;
 
-	for (;;)
-	{
-		// TODO: Wait for a message
-		rtems_message_queue_receive(tm_message_queue, &tm, &size, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+	tm_frame_reset(frame);
 
-		// TODO: Simulate processing
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &current_tick);
+	window_end = current_tick + TM_AGGREGATION_WINDOW;
 
-		PRINT_TIME("Sent TM => %s | %u | %s",
-				((tm.sender_id == housekeeping_task_id) ?
-				"HK" : "ACS"),
-				tm.data_size,
-				tm.data);
-		consume_ticks(1);
+	for (;;)
+	{
+		// Wait for a message until the end of the aggregation window
+		rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &current_tick);
+		if ((int32_t)(window_end - current_tick) > 0)
+		{
+			status = rtems_message_queue_receive(tm_message_queues[worker], &tm, &size,
+					RTEMS_WAIT, window_end - current_tick) ;
+
+			if (status == RTEMS_SUCCESSFUL)
+			{
+				// Discard malformed records
+				if (size < TM_MESSAGE_SIZE(0) ||
+					size != TM_MESSAGE_SIZE(tm.data_size))
+				{
+					PRINT_TIME("Discarded TM => bad size %u", size);
+					continue;
+				}
+
+				if (tm_frame_add(frame, &tm) != 0)
+				{
+					// The frame is full: send it and start a new one
+					tm_downlink_send(worker, frame);
+					if (tm_frame_add(frame, &tm) != 0)
+					{
+						PRINT_TIME("Discarded TM => unknown sender");
+					}
+				}
+
+				// Simulate processing
+				consume_ticks(1);
+				continue;
+			}
+		}
+
+		// End of the aggregation window
+		if (!tm_frame_is_empty(frame))
+		{
+			tm_downlink_send(worker, frame);
+		}
+		window_end += TM_AGGREGATION_WINDOW;
 
 	}
 }
@@ -98,34 +282,40 @@ rtems_task telemetry_server(rtems_task_argument argument)
  *
  * This task must implement an infinite loop that does the following:
  *
- * 1) occupies the CPU for 2 ticks
- * 2) sends a telemetry
- * 3) sleeps for 10 ticks
+ * 1) waits for the start of its period (HK_PERIOD ticks)
+ * 2) occupies the CPU for 2 ticks
+ * 3) sends a telemetry
  */
 
 rtems_task housekeeping_task(rtems_task_argument argument)
 {
+	periodic_t periodic;
 	telemetry_t tm;
 	tm.sender_id = housekeeping_task_id;
 	tm.counter = 0;
 
+	periodic_create(&periodic, rtems_build_name('H', 'K', 'P', 'R'), HK_PERIOD);
+
 	for (;;)
 	{
+		// TODO: Wait until next execution
+		periodic_wait(&periodic);
+		if ((periodic.activations % PERIODIC_REPORT_ACTIVATIONS) == 0)
+		{
+			periodic_report("HK", &periodic);
+		}
+
 		PRINT_TIME("HK Activation");
 		consume_ticks(2) ;
 
 		// TODO: Simulate processing
 
 		// Fill the telemetry packet
-		strcpy(tm.data, "SYSTEM OK");
-		tm.data_size = strlen(tm.data);
+		telemetry_set_data(&tm, "SYSTEM OK");
 		tm.counter++;
 
 		// TODO: Send the message
-		rtems_message_queue_send(tm_message_queue, &tm, sizeof(tm)) ;
-
-		// TODO: Wait until next execution
-		rtems_task_wake_after(10) ;
+		tm_producer_send(&housekeeping_producer, &tm) ;
 
 	}
 }
@@ -135,33 +325,39 @@ rtems_task housekeeping_task(rtems_task_argument argument)
  *
  * This task must implement an infinite loop that does the following:
  *
- * 1) occupies the CPU for 40 ticks
- * 2) sends a telemetry
- * 3) sleeps for 100 ticks
+ * 1) waits for the start of its period (ACS_PERIOD ticks)
+ * 2) occupies the CPU for 40 ticks
+ * 3) sends a telemetry
  */
 rtems_task acs_task(rtems_task_argument argument)
 {
+	periodic_t periodic;
 	telemetry_t tm;
 	tm.sender_id = acs_task_id;
 	tm.counter = 0;
 
+	periodic_create(&periodic, rtems_build_name('A', 'C', 'P', 'R'), ACS_PERIOD);
+
 	for (;;)
 	{
+		// TODO: Wait until next execution
+		periodic_wait(&periodic);
+		if ((periodic.activations % PERIODIC_REPORT_ACTIVATIONS) == 0)
+		{
+			periodic_report("ACS", &periodic);
+		}
+
 		PRINT_TIME("ACS Activation");
 
 		// TODO: Simulate processing
 		consume_ticks(40);
 
 		// Fill the telemetry packet
-		strcpy(tm.data, "ACS OK");
-		tm.data_size = strlen(tm.data);
+		telemetry_set_data(&tm, "ACS OK");
 		tm.counter++;
 
 		// TODO: Send the message
-		rtems_message_queue_send(tm_message_queue, &tm, sizeof(tm)) ;
-
-		rtems_task_wake_after(100) ;
-		// TODO: Wait until next execution
+		tm_producer_send(&acs_producer, &tm) ;
 
 	}
 }
@@ -169,19 +365,42 @@ rtems_task acs_task(rtems_task_argument argument)
 
 rtems_task Init(rtems_task_argument arg)
 {
+	int i, index;
+
+	// Calibrate the busy work against the clock, before any task runs
+	consume_calibrate();
+
+	// Start the asynchronous logging drain task
+	log_init(LOG_DRAIN_PRIORITY);
+
+	// Start the CPU usage reporter
+	cpu_usage_init(CPU_USAGE_REPORT_PRIORITY, CPU_USAGE_REPORT_PERIOD);
+
+#ifdef TM_BENCHMARK
+	tm_benchmark();
+#endif
 
 	// TODO: Create the message queue
-	rtems_message_queue_create(rtems_build_name('A', 'B', 'C', 'D'), 128, 64, RTEMS_FIFO, &tm_message_queue) ;
+	for (i = 0; i < TM_SERVER_WORKERS; i++)
+	{
+		rtems_message_queue_create(rtems_build_name('A', 'B', 'C', '0' + i),
+				TM_QUEUE_LENGTH, TM_MESSAGE_SIZE(TM_MAX_DATA_SIZE),
+				RTEMS_FIFO, &tm_message_queues[i]) ;
+	}
+
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &tm_downlink_start_tick);
 
 	// TODO: Create Telemetry Server
-	rtems_task_create(rtems_build_name('T', 'S', 'K', '1'),
-			10, RTEMS_MINIMUM_STACK_SIZE,
-			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
-			RTEMS_DEFAULT_ATTRIBUTES, &telemetry_server_id);
+	for (i = 0; i < TM_SERVER_WORKERS; i++)
+	{
+		rtems_task_create(rtems_build_name('T', 'S', 'V', '0' + i),
+				10, RTEMS_MINIMUM_STACK_SIZE,
+				RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+				RTEMS_DEFAULT_ATTRIBUTES, &telemetry_server_ids[i]);
 
-		// TODO: Start Logging Server
-	rtems_task_start(telemetry_server_id, telemetry_server, 0);
-	// TODO: Start Telemetry Server
+		// TODO: Start Telemetry Server
+		rtems_task_start(telemetry_server_ids[i], telemetry_server, i);
+	}
 
 	// TODO: Create Housekeeping task
 	rtems_task_create(rtems_build_name('T', 'S', 'K', '2'),
@@ -205,6 +424,19 @@ rtems_task Init(rtems_task_argument arg)
 
 	// TODO: Start ACS task
 
+	// Register the telemetry senders in the downlink codec and bind each
+	// producer to the queue of its shard. The tasks do not run until Init
+	// is deleted, as Init is not preemptible.
+	index = tm_codec_register_sender(housekeeping_task_id);
+	tm_producer_init(&housekeeping_producer,
+			tm_message_queues[TM_SERVER_SHARD(index)],
+			HK_OVERFLOW_POLICY, HK_OVERFLOW_TIMEOUT);
+
+	index = tm_codec_register_sender(acs_task_id);
+	tm_producer_init(&acs_producer,
+			tm_message_queues[TM_SERVER_SHARD(index)],
+			ACS_OVERFLOW_POLICY, ACS_OVERFLOW_TIMEOUT);
+
 	/** Delete the initial task from the system */
 	rtems_task_delete(RTEMS_SELF);
 
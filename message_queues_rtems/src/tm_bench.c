@@ -0,0 +1,306 @@
+/*
+ * Telemetry server scalability benchmark. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <telemetry.h>
+#include <tm_codec.h>
+#include <tm_producer.h>
+#include <tm_bench.h>
+
+/** Number of telemetries sent in each run */
+#define TM_BENCH_TELEMETRIES		2000
+
+/** Number of simulated senders */
+#define TM_BENCH_SENDERS		4
+
+/** Depth of each queue */
+#define TM_BENCH_QUEUE_LENGTH		32
+
+/** Telemetries per downlink frame */
+#define TM_BENCH_FRAME_TELEMETRIES	16
+
+/** Time the downlink driver blocks the worker per frame, in ticks */
+#define TM_BENCH_SEND_TICKS		1
+
+/** Maximum duration of a run, in ticks */
+#define TM_BENCH_RUN_TIMEOUT		6000
+
+#define TM_BENCH_PRODUCER_PRIORITY	15
+#define TM_BENCH_WORKER_PRIORITY	20
+
+/** Event sent to the controller when all the telemetries are processed */
+#define TM_BENCH_DONE_EVENT		RTEMS_EVENT_0
+
+static rtems_id tm_bench_controller_id;
+
+static rtems_id tm_bench_queues[TM_BENCH_MAX_WORKERS];
+
+/**
+ * Free slots of each queue. A classic message queue never blocks the
+ * sender, so the producer waits on this counting semaphore before sending,
+ * and the worker releases it after each receive: the producer sleeps until
+ * the worker makes room, instead of polling once per tick, and the runs
+ * measure the workers and not the tick.
+ */
+static rtems_id tm_bench_slots[TM_BENCH_MAX_WORKERS];
+
+static tm_producer_t tm_bench_producers[TM_BENCH_SENDERS];
+
+static rtems_id tm_bench_senders[TM_BENCH_SENDERS];
+
+static tm_frame_t tm_bench_frames[TM_BENCH_MAX_WORKERS];
+
+/** Last counter received from each sender, to check the ordering */
+static unsigned int tm_bench_last_counter[TM_BENCH_SENDERS];
+
+/** Number of telemetries received out of order */
+static unsigned int tm_bench_order_errors;
+
+/** Number of telemetries processed in the current run */
+static unsigned int tm_bench_processed;
+
+/** Number of workers of the current run */
+static int tm_bench_workers;
+
+static int tm_bench_sender_index(rtems_id sender_id)
+{
+	int i;
+
+	for (i = 0; i < TM_BENCH_SENDERS; i++)
+	{
+		if (tm_bench_senders[i] == sender_id)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Sends a frame. Formatting it stands for the CPU cost of the downlink,
+ * and the driver then blocks the worker for TM_BENCH_SEND_TICKS.
+ */
+static void tm_bench_send_frame(tm_frame_t * frame)
+{
+	static char line[TM_BENCH_MAX_WORKERS][2 * TM_FRAME_MAX_SIZE + 1];
+	unsigned int size, i;
+	int worker = frame - tm_bench_frames;
+
+	size = tm_frame_close(frame);
+	for (i = 0; i < size; i++)
+	{
+		sprintf(&line[worker][2 * i], "%02X", frame->buffer[i]);
+	}
+	rtems_task_wake_after(TM_BENCH_SEND_TICKS);
+
+	tm_frame_reset(frame);
+}
+
+static rtems_task tm_bench_worker(rtems_task_argument argument)
+{
+	int worker = argument;
+	tm_frame_t * frame = &tm_bench_frames[worker];
+	telemetry_t tm;
+	size_t size;
+	int index;
+	unsigned int processed;
+	rtems_interrupt_level level;
+
+	tm_frame_reset(frame);
+
+	for (;;)
+	{
+		rtems_message_queue_receive(tm_bench_queues[worker], &tm, &size,
+				RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		rtems_semaphore_release(tm_bench_slots[worker]);
+
+		// Each sender is served by a single worker, no locking needed
+		index = tm_bench_sender_index(tm.sender_id);
+		if (index >= 0)
+		{
+			if (tm.counter != tm_bench_last_counter[index] + 1)
+			{
+				tm_bench_order_errors++;
+			}
+			tm_bench_last_counter[index] = tm.counter;
+		}
+
+		if (tm_frame_add(frame, &tm) != 0)
+		{
+			tm_bench_send_frame(frame);
+			tm_frame_add(frame, &tm);
+		}
+		if (frame->telemetries >= TM_BENCH_FRAME_TELEMETRIES)
+		{
+			tm_bench_send_frame(frame);
+		}
+
+		rtems_interrupt_disable(level);
+		processed = ++tm_bench_processed;
+		rtems_interrupt_enable(level);
+
+		if (processed == TM_BENCH_TELEMETRIES)
+		{
+			rtems_event_send(tm_bench_controller_id, TM_BENCH_DONE_EVENT);
+		}
+	}
+}
+
+static rtems_task tm_bench_producer(rtems_task_argument argument)
+{
+	telemetry_t tm;
+	unsigned int counters[TM_BENCH_SENDERS] = { 0 };
+	int i, sender;
+
+	tm.data_size = 9;
+	tm.data[0] = 'S'; tm.data[1] = 'Y'; tm.data[2] = 'S';
+	tm.data[3] = 'T'; tm.data[4] = 'E'; tm.data[5] = 'M';
+	tm.data[6] = ' '; tm.data[7] = 'O'; tm.data[8] = 'K';
+
+	for (i = 0; i < TM_BENCH_TELEMETRIES; i++)
+	{
+		sender = i % TM_BENCH_SENDERS;
+		tm.sender_id = tm_bench_senders[sender];
+		tm.counter = ++counters[sender];
+		rtems_semaphore_obtain(tm_bench_slots[sender % tm_bench_workers],
+				RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		tm_producer_send(&tm_bench_producers[sender], &tm);
+	}
+
+	rtems_task_delete(RTEMS_SELF);
+}
+
+/** Runs the benchmark with the given number of workers */
+static void tm_bench_run(int nb_workers)
+{
+	rtems_id worker_ids[TM_BENCH_MAX_WORKERS];
+	rtems_id producer_id;
+	rtems_event_set events;
+	rtems_status_code status;
+	uint32_t start_tick, end_tick, ticks_per_second;
+	unsigned int dropped;
+	int i;
+
+	tm_bench_processed = 0;
+	tm_bench_order_errors = 0;
+	tm_bench_workers = nb_workers;
+
+	for (i = 0; i < nb_workers; i++)
+	{
+		rtems_message_queue_create(rtems_build_name('B', 'M', 'Q', '0' + i),
+				TM_BENCH_QUEUE_LENGTH, TM_MESSAGE_SIZE(TM_MAX_DATA_SIZE),
+				RTEMS_FIFO, &tm_bench_queues[i]);
+		rtems_semaphore_create(rtems_build_name('B', 'S', 'L', '0' + i),
+				TM_BENCH_QUEUE_LENGTH, RTEMS_COUNTING_SEMAPHORE | RTEMS_FIFO,
+				0, &tm_bench_slots[i]);
+
+		rtems_task_create(rtems_build_name('B', 'W', 'K', '0' + i),
+				TM_BENCH_WORKER_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+				RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+				RTEMS_DEFAULT_ATTRIBUTES, &worker_ids[i]);
+		rtems_task_start(worker_ids[i], tm_bench_worker, i);
+	}
+
+	// Shard the senders among the workers. The slots keep the queues from
+	// overflowing, so any drop is an error of the benchmark.
+	for (i = 0; i < TM_BENCH_SENDERS; i++)
+	{
+		tm_bench_last_counter[i] = 0;
+		tm_producer_init(&tm_bench_producers[i],
+				tm_bench_queues[i % nb_workers],
+				TM_OVERFLOW_DROP_NEWEST, 0);
+	}
+
+	rtems_task_create(rtems_build_name('B', 'P', 'R', 'D'),
+			TM_BENCH_PRODUCER_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &producer_id);
+
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &start_tick);
+	rtems_task_start(producer_id, tm_bench_producer, 0);
+
+	status = rtems_event_receive(TM_BENCH_DONE_EVENT, RTEMS_WAIT | RTEMS_EVENT_ANY,
+			TM_BENCH_RUN_TIMEOUT, &events);
+
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &end_tick);
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_PER_SECOND, &ticks_per_second);
+
+	dropped = 0;
+	for (i = 0; i < TM_BENCH_SENDERS; i++)
+	{
+		dropped += tm_bench_producers[i].dropped_newest +
+				tm_bench_producers[i].errors;
+	}
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		printf("%d worker(s) => timed out after %u TM\n",
+				nb_workers, tm_bench_processed);
+		// The producer may still be blocked on the slots of a queue
+		rtems_task_delete(producer_id);
+	}
+	else
+	{
+		printf("%d worker(s) => %u TM in %lu ticks | %lu TM/s | "
+				"out of order %u | dropped %u\n",
+				nb_workers, tm_bench_processed,
+				(unsigned long)(end_tick - start_tick),
+				(unsigned long)((unsigned long long) tm_bench_processed *
+						ticks_per_second / (end_tick - start_tick + 1)),
+				tm_bench_order_errors, dropped);
+	}
+
+	for (i = 0; i < nb_workers; i++)
+	{
+		rtems_task_delete(worker_ids[i]);
+		rtems_message_queue_delete(tm_bench_queues[i]);
+		rtems_semaphore_delete(tm_bench_slots[i]);
+	}
+}
+
+void tm_benchmark(void)
+{
+	int i;
+	rtems_mode previous_mode;
+
+	rtems_task_ident(RTEMS_SELF, 0, &tm_bench_controller_id);
+
+	// Let the tasks of each run preempt the controller, which only waits
+	// for the end of the run
+	rtems_task_mode(RTEMS_PREEMPT, RTEMS_PREEMPT_MASK, &previous_mode);
+
+	for (i = 0; i < TM_BENCH_SENDERS; i++)
+	{
+		tm_bench_senders[i] = rtems_build_name('S', 'N', 'D', '0' + i);
+		tm_codec_register_sender(tm_bench_senders[i]);
+	}
+
+	printf("Telemetry server benchmark: %u TM, %d senders, "
+			"%d TM/frame, %d tick(s)/frame\n",
+			TM_BENCH_TELEMETRIES, TM_BENCH_SENDERS,
+			TM_BENCH_FRAME_TELEMETRIES, TM_BENCH_SEND_TICKS);
+
+	for (i = 1; i <= TM_BENCH_MAX_WORKERS; i++)
+	{
+		tm_bench_run(i);
+	}
+
+	rtems_shutdown_executive(0);
+}
@@ -0,0 +1,162 @@
+/*
+ * Telemetry downlink frame codec. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <string.h>
+
+#include <tm_codec.h>
+
+/** Registered senders, indexed by sender index */
+static rtems_id tm_codec_senders[TM_CODEC_MAX_SENDERS];
+
+/** Number of registered senders */
+static int tm_codec_nb_senders = 0;
+
+int tm_codec_register_sender(rtems_id sender_id)
+{
+	if (tm_codec_nb_senders >= TM_CODEC_MAX_SENDERS)
+	{
+		return -1;
+	}
+	tm_codec_senders[tm_codec_nb_senders] = sender_id;
+	return tm_codec_nb_senders++;
+}
+
+static int tm_codec_sender_index(rtems_id sender_id)
+{
+	int i;
+
+	for (i = 0; i < tm_codec_nb_senders; i++)
+	{
+		if (tm_codec_senders[i] == sender_id)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void tm_frame_put_varint(tm_frame_t * frame, unsigned int value)
+{
+	while (value >= 0x80)
+	{
+		frame->buffer[frame->size++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	frame->buffer[frame->size++] = (unsigned char) value;
+}
+
+void tm_frame_reset(tm_frame_t * frame)
+{
+	int i;
+
+	frame->size = TM_FRAME_HEADER_SIZE;
+	frame->telemetries = 0;
+	frame->raw_size = 0;
+
+	for (i = 0; i < TM_CODEC_MAX_SENDERS; i++)
+	{
+		frame->entries[i].valid = 0;
+		frame->entries[i].run_offset = -1;
+	}
+}
+
+int tm_frame_add(tm_frame_t * frame, const telemetry_t * tm)
+{
+	tm_codec_entry_t * entry;
+	int index;
+
+	index = tm_codec_sender_index(tm->sender_id);
+
+	if (index < 0 || tm->data_size > TM_MAX_DATA_SIZE ||
+		frame->size + TM_REC_MAX_SIZE > TM_FRAME_MAX_SIZE)
+	{
+		return -1;
+	}
+
+	entry = &frame->entries[index];
+
+	if (tm->lost > 0)
+	{
+		frame->buffer[frame->size++] = TM_REC_LOST | index;
+		tm_frame_put_varint(frame, tm->lost);
+		entry->run_offset = -1;
+	}
+
+	if (entry->valid && entry->data_size == tm->data_size &&
+		memcmp(entry->data, tm->data, tm->data_size) == 0)
+	{
+		unsigned int delta = tm->counter - entry->counter;
+
+		if (delta == 1 && entry->run_offset >= 0 &&
+			frame->buffer[entry->run_offset + 1] < 0xFF)
+		{
+			// Extend the current run
+			frame->buffer[entry->run_offset + 1]++;
+		}
+		else if (delta == 1)
+		{
+			// Start a new run
+			entry->run_offset = frame->size;
+			frame->buffer[frame->size++] = TM_REC_RUN | index;
+			frame->buffer[frame->size++] = 1;
+		}
+		else
+		{
+			frame->buffer[frame->size++] = TM_REC_REPEAT | index;
+			tm_frame_put_varint(frame, delta);
+			entry->run_offset = -1;
+		}
+	}
+	else
+	{
+		frame->buffer[frame->size++] = TM_REC_FULL | index;
+		tm_frame_put_varint(frame, tm->counter);
+		frame->buffer[frame->size++] = (unsigned char) tm->data_size;
+		memcpy(&frame->buffer[frame->size], tm->data, tm->data_size);
+		frame->size += tm->data_size;
+
+		entry->valid = 1;
+		entry->data_size = tm->data_size;
+		memcpy(entry->data, tm->data, tm->data_size);
+		entry->run_offset = -1;
+	}
+
+	entry->counter = tm->counter;
+	frame->telemetries++;
+	frame->raw_size += TM_MESSAGE_SIZE(tm->data_size);
+
+	return 0;
+}
+
+int tm_frame_is_empty(const tm_frame_t * frame)
+{
+	return (frame->telemetries == 0);
+}
+
+unsigned int tm_frame_close(tm_frame_t * frame)
+{
+	unsigned int length = frame->size - TM_FRAME_HEADER_SIZE;
+
+	frame->buffer[0] = TM_FRAME_SYNC_0;
+	frame->buffer[1] = TM_FRAME_SYNC_1;
+	frame->buffer[2] = (unsigned char)(length >> 8);
+	frame->buffer[3] = (unsigned char)(length & 0xFF);
+
+	return frame->size;
+}
@@ -0,0 +1,124 @@
+/*
+ * Telemetry producer overflow policies. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <tm_producer.h>
+
+void tm_producer_init(tm_producer_t * producer, rtems_id queue,
+		tm_overflow_policy_t policy, rtems_interval timeout)
+{
+	producer->queue = queue;
+	producer->policy = policy;
+	producer->timeout = timeout;
+
+	producer->sent = 0;
+	producer->dropped_newest = 0;
+	producer->dropped_oldest = 0;
+	producer->coalesced = 0;
+	producer->timeouts = 0;
+	producer->errors = 0;
+
+	producer->pending_lost = 0;
+}
+
+rtems_status_code tm_producer_send(tm_producer_t * producer, telemetry_t * tm)
+{
+	rtems_status_code status;
+	telemetry_t oldest;
+	size_t size;
+	rtems_interval waited = 0;
+
+	tm->lost = producer->pending_lost;
+
+	status = rtems_message_queue_send(producer->queue, tm,
+			TM_MESSAGE_SIZE(tm->data_size));
+
+	while (status == RTEMS_TOO_MANY)
+	{
+		switch (producer->policy)
+		{
+		case TM_OVERFLOW_DROP_OLDEST:
+			if (rtems_message_queue_receive(producer->queue, &oldest, &size,
+					RTEMS_NO_WAIT, RTEMS_NO_TIMEOUT) == RTEMS_SUCCESSFUL)
+			{
+				producer->dropped_oldest++;
+				status = rtems_message_queue_send(producer->queue, tm,
+						TM_MESSAGE_SIZE(tm->data_size));
+				if (status != RTEMS_TOO_MANY)
+				{
+					continue;
+				}
+			}
+			// Another producer took the slot: drop the new telemetry
+			producer->dropped_newest++;
+			return status;
+
+		case TM_OVERFLOW_COALESCE:
+			producer->coalesced++;
+			if (producer->pending_lost < 0xFFFF)
+			{
+				producer->pending_lost++;
+			}
+			return status;
+
+		case TM_OVERFLOW_BLOCK:
+			if (waited >= producer->timeout)
+			{
+				producer->timeouts++;
+				return RTEMS_TIMEOUT;
+			}
+			rtems_task_wake_after(1);
+			waited++;
+			status = rtems_message_queue_send(producer->queue, tm,
+					TM_MESSAGE_SIZE(tm->data_size));
+			break;
+
+		case TM_OVERFLOW_DROP_NEWEST:
+		default:
+			producer->dropped_newest++;
+			return status;
+		}
+	}
+
+	if (status == RTEMS_SUCCESSFUL)
+	{
+		producer->sent++;
+		producer->pending_lost = 0;
+	}
+	else
+	{
+		producer->errors++;
+	}
+
+	return status;
+}
+
+void tm_producer_report(const char * name, const tm_producer_t * producer)
+{
+	printf("%s => sent %u | drop-newest %u | drop-oldest %u | "
+			"coalesced %u | timeouts %u | errors %u\n",
+			name,
+			producer->sent,
+			producer->dropped_newest,
+			producer->dropped_oldest,
+			producer->coalesced,
+			producer->timeouts,
+			producer->errors);
+}
@@ -0,0 +1,51 @@
+/*
+ * Response time analysis tool: worst-case response times. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ANALYSIS_H__
+#define __ANALYSIS_H__
+
+#include <taskset.h>
+
+/** Response time above which the analysis gives up */
+#define ANALYSIS_LIMIT			1000000
+
+typedef struct {
+
+	unsigned int execution;
+	/** Blocking term due to lower priority tasks */
+	unsigned int blocking;
+	/** Blocking is unbounded (resources without protocol) */
+	int unbounded;
+	/** Worst-case response time, valid if converged */
+	unsigned int response;
+	int converged;
+
+} analysis_result_t;
+
+/**
+ * Computes the worst-case response time of every task with the classic
+ * fixed priority recurrence, R = C + B + sum(ceil(R / Tj) * Cj), where
+ * tasks without period interfere once. The blocking term B is the sum of
+ * the critical sections that can block the task for priority inheritance
+ * resources and the longest one for priority ceiling resources. Returns
+ * 0 on success, or -1 if the task set is invalid (e.g. a task above the
+ * ceiling of a resource it uses).
+ */
+int analysis_run(const taskset_t * taskset, analysis_result_t * results);
+
+#endif // __ANALYSIS_H__
@@ -0,0 +1,35 @@
+/*
+ * Response time analysis tool: log comparison. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LOG_COMPARE_H__
+#define __LOG_COMPARE_H__
+
+#include <simulation.h>
+
+/**
+ * Compares the simulated events with the "<tick>: <message>" lines of the
+ * log of a real run. Each simulated event is matched with the next log
+ * line with the same message, and both timelines are aligned on the first
+ * match. Prints one line per event and returns the number of events that
+ * are missing or deviate more than tolerance ticks, or -1 if the log
+ * cannot be read.
+ */
+int log_compare(const taskset_t * taskset, const simulation_t * simulation,
+		const char * path, unsigned int tolerance);
+
+#endif // __LOG_COMPARE_H__
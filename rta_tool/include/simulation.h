@@ -0,0 +1,57 @@
+/*
+ * Response time analysis tool: timeline simulation. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SIMULATION_H__
+#define __SIMULATION_H__
+
+#include <taskset.h>
+
+#define SIMULATION_MAX_EVENTS		4096
+
+typedef struct {
+
+	unsigned int tick;
+	int task;
+	char message[TASKSET_MAX_MESSAGE];
+
+} simulation_event_t;
+
+typedef struct {
+
+	simulation_event_t events[SIMULATION_MAX_EVENTS];
+	unsigned int event_count;
+
+	/** Worst observed response time and completed jobs of each task */
+	unsigned int max_response[TASKSET_MAX_TASKS];
+	unsigned int jobs[TASKSET_MAX_TASKS];
+	/** Jobs still running when the next one was released */
+	unsigned int overruns[TASKSET_MAX_TASKS];
+
+} simulation_t;
+
+/**
+ * Simulates the task set tick by tick, as the RTEMS scheduler runs it:
+ * preemptive fixed priorities, FIFO among equal priorities, priority
+ * inheritance that is not transitive and raised priorities that are only
+ * restored when the task releases its last resource. Periodic tasks run
+ * until the horizon, the others until they finish.
+ */
+void simulation_run(const taskset_t * taskset, unsigned int horizon,
+		simulation_t * simulation);
+
+#endif // __SIMULATION_H__
@@ -0,0 +1,125 @@
+/*
+ * Response time analysis tool: task set model. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TASKSET_H__
+#define __TASKSET_H__
+
+/**
+ * Task set model. Times are in clock ticks and priorities follow the RTEMS
+ * convention: the lower the number, the higher the priority.
+ *
+ * A task set file is a sequence of lines ('#' starts a comment):
+ *
+ *   resource <name> none|inherit|ceiling [<ceiling>] [fifo|priority]
+ *   task <name> <priority> [offset <n>] [period <n>] [deadline <n>]
+ *     log "<message>"
+ *     run <n>
+ *     lock <resource>
+ *     unlock <resource>
+ *   end
+ *
+ * A task without period runs once, released <offset> ticks after the
+ * start of the system (rtems_task_wake_after() at the beginning of the
+ * task). The log steps name the PRINT_TIME messages of the real task, so
+ * that its logged timeline can be checked against the simulated one.
+ */
+
+#define TASKSET_MAX_TASKS		32
+#define TASKSET_MAX_RESOURCES		16
+#define TASKSET_MAX_STEPS		64
+#define TASKSET_MAX_NAME		32
+#define TASKSET_MAX_MESSAGE		96
+
+typedef enum {
+
+	PROTOCOL_NONE,
+	PROTOCOL_INHERIT,
+	PROTOCOL_CEILING
+
+} protocol_t;
+
+typedef enum {
+
+	STEP_RUN,
+	STEP_LOCK,
+	STEP_UNLOCK,
+	STEP_LOG
+
+} step_type_t;
+
+typedef struct {
+
+	step_type_t type;
+	/** Ticks of a STEP_RUN */
+	unsigned int ticks;
+	/** Resource of a STEP_LOCK or STEP_UNLOCK */
+	int resource;
+	/** Message of a STEP_LOG */
+	char message[TASKSET_MAX_MESSAGE];
+
+} step_t;
+
+typedef struct {
+
+	char name[TASKSET_MAX_NAME];
+	protocol_t protocol;
+	/** Declared ceiling, for PROTOCOL_CEILING */
+	unsigned int ceiling;
+	/** Waiters are served by priority instead of FIFO */
+	int priority_queue;
+
+} resource_t;
+
+typedef struct {
+
+	char name[TASKSET_MAX_NAME];
+	unsigned int priority;
+	unsigned int offset;
+	/** 0 for tasks that run once */
+	unsigned int period;
+	/** 0 when there is no deadline */
+	unsigned int deadline;
+
+	step_t steps[TASKSET_MAX_STEPS];
+	unsigned int step_count;
+
+} task_t;
+
+typedef struct {
+
+	resource_t resources[TASKSET_MAX_RESOURCES];
+	unsigned int resource_count;
+
+	task_t tasks[TASKSET_MAX_TASKS];
+	unsigned int task_count;
+
+} taskset_t;
+
+/**
+ * Loads a task set file. Returns 0 on success, or -1 after printing the
+ * error on stderr.
+ */
+int taskset_load(taskset_t * taskset, const char * path);
+
+/** Returns the execution time of a job of a task */
+unsigned int taskset_execution_time(const task_t * task);
+
+/** Returns the name of a protocol */
+const char * taskset_protocol_name(protocol_t protocol);
+
+#endif // __TASKSET_H__
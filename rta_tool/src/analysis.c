@@ -0,0 +1,258 @@
+/*
+ * Response time analysis tool: worst-case response times. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+
+#include <analysis.h>
+
+/**
+ * Longest time a task runs with a resource locked. RTEMS only restores
+ * the priority of a task when it releases its last resource, so the
+ * section lasts until the end of the outermost section that contains it.
+ */
+static unsigned int analysis_section(const task_t * task, int resource)
+{
+	unsigned int longest = 0;
+	unsigned int length = 0;
+	unsigned int depth = 0;
+	int inside = 0;
+	unsigned int s;
+
+	for (s = 0; s < task->step_count; s++)
+	{
+		const step_t * step = &task->steps[s];
+
+		switch (step->type)
+		{
+		case STEP_LOCK:
+			if (step->resource == resource && !inside)
+			{
+				inside = 1;
+				length = 0;
+			}
+			depth++;
+			break;
+		case STEP_UNLOCK:
+			depth--;
+			if (inside && depth == 0)
+			{
+				inside = 0;
+				if (length > longest)
+				{
+					longest = length;
+				}
+			}
+			break;
+		case STEP_RUN:
+			length += step->ticks;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return longest;
+}
+
+static int analysis_uses(const task_t * task, int resource)
+{
+	unsigned int s;
+
+	for (s = 0; s < task->step_count; s++)
+	{
+		if (task->steps[s].type == STEP_LOCK && task->steps[s].resource == resource)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/** Highest priority (lowest number) that may lock a resource */
+static unsigned int analysis_ceiling(const taskset_t * taskset, int resource)
+{
+	unsigned int ceiling = 0xFFFFFFFF;
+	unsigned int t;
+
+	if (taskset->resources[resource].protocol == PROTOCOL_CEILING)
+	{
+		return taskset->resources[resource].ceiling;
+	}
+
+	for (t = 0; t < taskset->task_count; t++)
+	{
+		if (analysis_uses(&taskset->tasks[t], resource) &&
+				taskset->tasks[t].priority < ceiling)
+		{
+			ceiling = taskset->tasks[t].priority;
+		}
+	}
+
+	return ceiling;
+}
+
+static void analysis_blocking(const taskset_t * taskset, unsigned int i,
+		analysis_result_t * result)
+{
+	unsigned int priority = taskset->tasks[i].priority;
+	unsigned int ceiling_blocking = 0;
+	unsigned int per_resource = 0;
+	unsigned int per_task = 0;
+	unsigned int longest[TASKSET_MAX_TASKS] = { 0 };
+	unsigned int section, worst;
+	unsigned int r, j, k;
+
+	for (r = 0; r < taskset->resource_count; r++)
+	{
+		const resource_t * resource = &taskset->resources[r];
+
+		if (analysis_ceiling(taskset, r) > priority)
+		{
+			// No task at or above our priority uses it
+			continue;
+		}
+
+		if (resource->protocol == PROTOCOL_NONE && !analysis_uses(&taskset->tasks[i], r))
+		{
+			// Nobody inherits its priority, so only its users wait for it
+			continue;
+		}
+
+		worst = 0;
+		for (j = 0; j < taskset->task_count; j++)
+		{
+			if (taskset->tasks[j].priority <= priority ||
+					!analysis_uses(&taskset->tasks[j], r))
+			{
+				continue;
+			}
+
+			section = analysis_section(&taskset->tasks[j], r);
+
+			if (resource->protocol == PROTOCOL_CEILING)
+			{
+				if (section > ceiling_blocking)
+				{
+					ceiling_blocking = section;
+				}
+				continue;
+			}
+
+			if (section > worst)
+			{
+				worst = section;
+			}
+			if (section > longest[j])
+			{
+				longest[j] = section;
+			}
+
+			// Without protocol, any task between both priorities may
+			// extend the blocking without bound
+			if (resource->protocol == PROTOCOL_NONE)
+			{
+				for (k = 0; k < taskset->task_count; k++)
+				{
+					if (taskset->tasks[k].priority > priority &&
+							taskset->tasks[k].priority < taskset->tasks[j].priority)
+					{
+						result->unbounded = 1;
+					}
+				}
+			}
+		}
+
+		per_resource += worst;
+	}
+
+	// Each lower priority task blocks at most once, and so does each
+	// resource
+	for (j = 0; j < taskset->task_count; j++)
+	{
+		per_task += longest[j];
+	}
+
+	result->blocking = ceiling_blocking +
+			((per_resource < per_task) ? per_resource : per_task);
+}
+
+int analysis_run(const taskset_t * taskset, analysis_result_t * results)
+{
+	unsigned int i, j, r;
+	unsigned int response, next, jobs;
+
+	// RTEMS refuses to lock a ceiling resource above its ceiling
+	for (r = 0; r < taskset->resource_count; r++)
+	{
+		if (taskset->resources[r].protocol != PROTOCOL_CEILING)
+		{
+			continue;
+		}
+		for (j = 0; j < taskset->task_count; j++)
+		{
+			if (analysis_uses(&taskset->tasks[j], r) &&
+					taskset->tasks[j].priority < taskset->resources[r].ceiling)
+			{
+				fprintf(stderr, "task %s (priority %u) is above the ceiling of %s (%u)\n",
+						taskset->tasks[j].name, taskset->tasks[j].priority,
+						taskset->resources[r].name, taskset->resources[r].ceiling);
+				return -1;
+			}
+		}
+	}
+
+	for (i = 0; i < taskset->task_count; i++)
+	{
+		analysis_result_t * result = &results[i];
+
+		result->execution = taskset_execution_time(&taskset->tasks[i]);
+		result->unbounded = 0;
+		analysis_blocking(taskset, i, result);
+
+		// Fixed point of the response time recurrence
+		response = result->execution + result->blocking;
+		result->converged = 0;
+
+		while (response <= ANALYSIS_LIMIT)
+		{
+			next = result->execution + result->blocking;
+			for (j = 0; j < taskset->task_count; j++)
+			{
+				if (j == i || taskset->tasks[j].priority > taskset->tasks[i].priority)
+				{
+					continue;
+				}
+				jobs = (taskset->tasks[j].period == 0) ? 1 :
+						(response + taskset->tasks[j].period - 1) / taskset->tasks[j].period;
+				next += jobs * taskset_execution_time(&taskset->tasks[j]);
+			}
+
+			if (next == response)
+			{
+				result->converged = 1;
+				break;
+			}
+			response = next;
+		}
+
+		result->response = response;
+	}
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Response time analysis tool: log comparison. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <log_compare.h>
+
+#define LOG_COMPARE_MAX_LINES		16384
+#define LOG_COMPARE_MAX_LINE		256
+
+typedef struct {
+
+	unsigned long tick;
+	char message[TASKSET_MAX_MESSAGE];
+	int used;
+
+} log_line_t;
+
+/** Reads the "<tick>: <message>" lines of a log. Returns their number. */
+static int log_compare_read(const char * path, log_line_t * lines)
+{
+	char buffer[LOG_COMPARE_MAX_LINE];
+	log_line_t * line;
+	char * message;
+	size_t length;
+	int count = 0;
+	FILE * file;
+
+	file = fopen(path, "r");
+	if (file == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	while (count < LOG_COMPARE_MAX_LINES && fgets(buffer, sizeof(buffer), file) != NULL)
+	{
+		line = &lines[count];
+
+		line->tick = strtoul(buffer, &message, 10);
+		if (message == buffer || message[0] != ':' || message[1] != ' ')
+		{
+			continue;
+		}
+		message += 2;
+
+		length = strlen(message);
+		while (length > 0 && (message[length - 1] == '\n' ||
+				message[length - 1] == '\r' || message[length - 1] == ' '))
+		{
+			message[--length] = '\0';
+		}
+
+		strncpy(line->message, message, TASKSET_MAX_MESSAGE - 1);
+		line->message[TASKSET_MAX_MESSAGE - 1] = '\0';
+		line->used = 0;
+		count++;
+	}
+
+	fclose(file);
+
+	return count;
+}
+
+int log_compare(const taskset_t * taskset, const simulation_t * simulation,
+		const char * path, unsigned int tolerance)
+{
+	log_line_t * lines;
+	const simulation_event_t * event;
+	long offset = 0;
+	long observed, delta;
+	int aligned = 0;
+	int failures = 0;
+	int count, l;
+	unsigned int e;
+
+	lines = calloc(LOG_COMPARE_MAX_LINES, sizeof(log_line_t));
+	if (lines == NULL)
+	{
+		return -1;
+	}
+
+	count = log_compare_read(path, lines);
+	if (count < 0)
+	{
+		free(lines);
+		return -1;
+	}
+
+	printf("%8s %8s %6s  %-8s %s\n", "expected", "observed", "delta", "task", "message");
+
+	for (e = 0; e < simulation->event_count; e++)
+	{
+		event = &simulation->events[e];
+
+		for (l = 0; l < count; l++)
+		{
+			if (!lines[l].used && strcmp(lines[l].message, event->message) == 0)
+			{
+				break;
+			}
+		}
+
+		if (l == count)
+		{
+			printf("%8u %8s %6s  %-8s %s  <- MISSING\n", event->tick, "-", "-",
+					taskset->tasks[event->task].name, event->message);
+			failures++;
+			continue;
+		}
+
+		lines[l].used = 1;
+
+		// The first matched event sets the origin of the log
+		if (!aligned)
+		{
+			offset = (long) lines[l].tick - (long) event->tick;
+			aligned = 1;
+		}
+
+		observed = (long) lines[l].tick - offset;
+		delta = observed - (long) event->tick;
+
+		printf("%8u %8ld %+6ld  %-8s %s%s\n", event->tick, observed, delta,
+				taskset->tasks[event->task].name, event->message,
+				(labs(delta) > (long) tolerance) ? "  <- DEVIATION" : "");
+
+		if (labs(delta) > (long) tolerance)
+		{
+			failures++;
+		}
+	}
+
+	free(lines);
+
+	return failures;
+}
@@ -0,0 +1,194 @@
+/*
+ * Response time analysis tool. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <taskset.h>
+#include <analysis.h>
+#include <simulation.h>
+#include <log_compare.h>
+
+/** Default simulation horizon, in ticks */
+#define RTA_DEFAULT_HORIZON		10000
+
+/** Default tolerance of the log comparison, in ticks */
+#define RTA_DEFAULT_TOLERANCE		1
+
+static taskset_t taskset;
+static analysis_result_t results[TASKSET_MAX_TASKS];
+static simulation_t simulation;
+
+static void usage(const char * program)
+{
+	fprintf(stderr,
+			"usage: %s [-H horizon] [-t tolerance] [-T] <taskset> [<log>]\n"
+			"  -H  simulation horizon, in ticks (default %u)\n"
+			"  -t  allowed deviation of the logged events, in ticks (default %u)\n"
+			"  -T  print the simulated timeline, in the format of PRINT_TIME\n",
+			program, RTA_DEFAULT_HORIZON, RTA_DEFAULT_TOLERANCE);
+}
+
+int main(int argc, char * argv[])
+{
+	unsigned int horizon = RTA_DEFAULT_HORIZON;
+	unsigned int tolerance = RTA_DEFAULT_TOLERANCE;
+	int print_timeline = 0;
+	int failures = 0;
+	int deviations;
+	unsigned int i;
+	int option;
+
+	while ((option = getopt(argc, argv, "H:t:T")) != -1)
+	{
+		switch (option)
+		{
+		case 'H':
+			horizon = (unsigned int) strtoul(optarg, NULL, 10);
+			break;
+		case 't':
+			tolerance = (unsigned int) strtoul(optarg, NULL, 10);
+			break;
+		case 'T':
+			print_timeline = 1;
+			break;
+		default:
+			usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind >= argc || argc - optind > 2)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+
+	if (taskset_load(&taskset, argv[optind]) != 0 ||
+			analysis_run(&taskset, results) != 0)
+	{
+		return 2;
+	}
+
+	simulation_run(&taskset, horizon, &simulation);
+
+	printf("Resources:\n");
+	for (i = 0; i < taskset.resource_count; i++)
+	{
+		printf("  %-8s %s", taskset.resources[i].name,
+				taskset_protocol_name(taskset.resources[i].protocol));
+		if (taskset.resources[i].protocol == PROTOCOL_CEILING)
+		{
+			printf(" %u", taskset.resources[i].ceiling);
+		}
+		printf("%s\n", taskset.resources[i].priority_queue ? "" : " fifo");
+	}
+
+	printf("\n%-8s %4s %6s %6s %6s %6s %6s %6s %6s  %s\n", "task", "prio",
+			"C", "T", "D", "B", "R", "sim R", "margin", "status");
+
+	for (i = 0; i < taskset.task_count; i++)
+	{
+		const task_t * task = &taskset.tasks[i];
+		const analysis_result_t * result = &results[i];
+		const char * status = "ok";
+
+		printf("%-8s %4u %6u %6u %6u ", task->name, task->priority,
+				result->execution, task->period, task->deadline);
+
+		if (result->unbounded)
+		{
+			printf("%6s %6s ", "inf", "inf");
+		}
+		else if (result->converged)
+		{
+			printf("%6u %6u ", result->blocking, result->response);
+		}
+		else
+		{
+			printf("%6u %6s ", result->blocking, ">limit");
+		}
+
+		printf("%6u ", simulation.max_response[i]);
+
+		if (task->deadline > 0 && !result->unbounded && result->converged)
+		{
+			printf("%6d ", (int) task->deadline - (int) result->response);
+		}
+		else
+		{
+			printf("%6s ", "-");
+		}
+
+		if (result->unbounded)
+		{
+			status = "UNBOUNDED BLOCKING";
+			if (task->deadline > 0)
+			{
+				failures++;
+			}
+		}
+		else if (!result->converged ||
+				(task->deadline > 0 && result->response > task->deadline))
+		{
+			status = "DEADLINE NOT GUARANTEED";
+			failures++;
+		}
+		else if (simulation.max_response[i] > result->response)
+		{
+			status = "SIMULATION ABOVE BOUND";
+			failures++;
+		}
+		else if (simulation.overruns[i] > 0)
+		{
+			status = "OVERRUN IN SIMULATION";
+			failures++;
+		}
+		else if (simulation.jobs[i] == 0)
+		{
+			status = "NEVER FINISHED IN SIMULATION";
+			failures++;
+		}
+
+		printf(" %s\n", status);
+	}
+
+	if (print_timeline)
+	{
+		printf("\nSimulated timeline:\n");
+		for (i = 0; i < simulation.event_count; i++)
+		{
+			printf("%u: %s\n", simulation.events[i].tick, simulation.events[i].message);
+		}
+	}
+
+	if (argc - optind == 2)
+	{
+		printf("\nLog %s:\n", argv[optind + 1]);
+		deviations = log_compare(&taskset, &simulation, argv[optind + 1], tolerance);
+		if (deviations < 0)
+		{
+			return 2;
+		}
+		printf("%d event(s) out of tolerance (%u ticks)\n", deviations, tolerance);
+		failures += deviations;
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
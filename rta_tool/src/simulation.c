@@ -0,0 +1,385 @@
+/*
+ * Response time analysis tool: timeline simulation. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <simulation.h>
+
+#define SIMULATION_NEVER		0xFFFFFFFF
+
+typedef struct {
+
+	/** A job is in progress */
+	int active;
+	/** The task runs once and is done */
+	int done;
+	/** A job was released while the previous one was in progress */
+	int pending;
+
+	unsigned int step;
+	/** Ticks left of the current STEP_RUN */
+	unsigned int remaining;
+
+	unsigned int priority;
+	/** Position among the ready tasks of the same priority */
+	long order;
+
+	/** Resource the task waits for, or -1 */
+	int blocked_on;
+	/** Order of arrival to the resource wait queue */
+	long wait_order;
+	/** Resources held */
+	unsigned int held;
+
+	unsigned int release;
+	unsigned int next_release;
+
+} simulation_task_t;
+
+typedef struct {
+
+	const taskset_t * taskset;
+	simulation_t * simulation;
+	simulation_task_t tasks[TASKSET_MAX_TASKS];
+	/** Holder of each resource, or -1 */
+	int holders[TASKSET_MAX_RESOURCES];
+	/** Counters to append to and prepend to the ready order */
+	long tail;
+	long head;
+
+} simulation_state_t;
+
+static void simulation_enter_step(simulation_state_t * state, int t)
+{
+	const task_t * task = &state->taskset->tasks[t];
+	simulation_task_t * sim = &state->tasks[t];
+
+	if (sim->step < task->step_count && task->steps[sim->step].type == STEP_RUN)
+	{
+		sim->remaining = task->steps[sim->step].ticks;
+	}
+}
+
+static void simulation_next_step(simulation_state_t * state, int t)
+{
+	state->tasks[t].step++;
+	simulation_enter_step(state, t);
+}
+
+static void simulation_start_job(simulation_state_t * state, int t,
+		unsigned int now)
+{
+	simulation_task_t * sim = &state->tasks[t];
+
+	sim->active = 1;
+	sim->step = 0;
+	sim->release = now;
+	sim->order = state->tail++;
+	simulation_enter_step(state, t);
+}
+
+/** Raises a task to a priority, moving it to the end of that priority */
+static void simulation_raise(simulation_state_t * state, int t,
+		unsigned int priority)
+{
+	if (priority < state->tasks[t].priority)
+	{
+		state->tasks[t].priority = priority;
+		state->tasks[t].order = state->tail++;
+	}
+}
+
+/** Gives a resource to a task, applying the ceiling if it has one */
+static void simulation_acquire(simulation_state_t * state, int t, int r)
+{
+	const resource_t * resource = &state->taskset->resources[r];
+
+	state->holders[r] = t;
+	state->tasks[t].held++;
+	if (resource->protocol == PROTOCOL_CEILING)
+	{
+		simulation_raise(state, t, resource->ceiling);
+	}
+}
+
+static void simulation_release(simulation_state_t * state, int t, int r)
+{
+	const resource_t * resource = &state->taskset->resources[r];
+	simulation_task_t * sim = &state->tasks[t];
+	int waiter = -1;
+	unsigned int w;
+
+	state->holders[r] = -1;
+	sim->held--;
+
+	// RTEMS only restores the priority after the last release, and the
+	// task goes back to the head of its priority
+	if (sim->held == 0 && sim->priority != state->taskset->tasks[t].priority)
+	{
+		sim->priority = state->taskset->tasks[t].priority;
+		sim->order = state->head--;
+	}
+
+	for (w = 0; w < state->taskset->task_count; w++)
+	{
+		simulation_task_t * candidate = &state->tasks[w];
+
+		if (candidate->blocked_on != r)
+		{
+			continue;
+		}
+		if (waiter < 0)
+		{
+			waiter = w;
+		}
+		else if (resource->priority_queue &&
+				candidate->priority != state->tasks[waiter].priority)
+		{
+			if (candidate->priority < state->tasks[waiter].priority)
+			{
+				waiter = w;
+			}
+		}
+		else if (candidate->wait_order < state->tasks[waiter].wait_order)
+		{
+			waiter = w;
+		}
+	}
+
+	// The resource is handed over to the first waiter
+	if (waiter >= 0)
+	{
+		state->tasks[waiter].blocked_on = -1;
+		state->tasks[waiter].order = state->tail++;
+		simulation_acquire(state, waiter, r);
+		simulation_next_step(state, waiter);
+	}
+}
+
+static int simulation_pick(const simulation_state_t * state)
+{
+	int selected = -1;
+	unsigned int t;
+
+	for (t = 0; t < state->taskset->task_count; t++)
+	{
+		const simulation_task_t * sim = &state->tasks[t];
+
+		if (!sim->active || sim->blocked_on >= 0)
+		{
+			continue;
+		}
+		if (selected < 0 || sim->priority < state->tasks[selected].priority ||
+				(sim->priority == state->tasks[selected].priority &&
+				sim->order < state->tasks[selected].order))
+		{
+			selected = t;
+		}
+	}
+
+	return selected;
+}
+
+static void simulation_log(simulation_state_t * state, int t,
+		unsigned int now, const char * message)
+{
+	simulation_t * simulation = state->simulation;
+	simulation_event_t * event;
+
+	if (simulation->event_count >= SIMULATION_MAX_EVENTS)
+	{
+		return;
+	}
+
+	event = &simulation->events[simulation->event_count++];
+	event->tick = now;
+	event->task = t;
+	strncpy(event->message, message, TASKSET_MAX_MESSAGE - 1);
+	event->message[TASKSET_MAX_MESSAGE - 1] = '\0';
+}
+
+static void simulation_finish_job(simulation_state_t * state, int t,
+		unsigned int now)
+{
+	simulation_task_t * sim = &state->tasks[t];
+	unsigned int response = now - sim->release;
+
+	state->simulation->jobs[t]++;
+	if (response > state->simulation->max_response[t])
+	{
+		state->simulation->max_response[t] = response;
+	}
+
+	sim->active = 0;
+	if (sim->pending)
+	{
+		// As a rate monotonic period after an overrun, the next job
+		// starts right away
+		sim->pending = 0;
+		simulation_start_job(state, t, now);
+	}
+	else if (state->taskset->tasks[t].period == 0)
+	{
+		sim->done = 1;
+	}
+}
+
+/**
+ * Runs the steps that take no time of the tasks selected to run, until
+ * one of them needs the CPU. Returns that task, or -1 if none is ready.
+ */
+static int simulation_dispatch(simulation_state_t * state, unsigned int now)
+{
+	const step_t * step;
+	int holder;
+	int t;
+
+	while ((t = simulation_pick(state)) >= 0)
+	{
+		const task_t * task = &state->taskset->tasks[t];
+		simulation_task_t * sim = &state->tasks[t];
+
+		if (sim->step >= task->step_count)
+		{
+			simulation_finish_job(state, t, now);
+			continue;
+		}
+
+		step = &task->steps[sim->step];
+
+		switch (step->type)
+		{
+		case STEP_LOG:
+			simulation_log(state, t, now, step->message);
+			simulation_next_step(state, t);
+			break;
+
+		case STEP_LOCK:
+			holder = state->holders[step->resource];
+			if (holder < 0)
+			{
+				simulation_acquire(state, t, step->resource);
+				simulation_next_step(state, t);
+			}
+			else
+			{
+				sim->blocked_on = step->resource;
+				sim->wait_order = state->tail++;
+				if (state->taskset->resources[step->resource].protocol == PROTOCOL_INHERIT)
+				{
+					simulation_raise(state, holder, sim->priority);
+				}
+			}
+			break;
+
+		case STEP_UNLOCK:
+			simulation_release(state, t, step->resource);
+			simulation_next_step(state, t);
+			break;
+
+		case STEP_RUN:
+			if (sim->remaining > 0)
+			{
+				return t;
+			}
+			simulation_next_step(state, t);
+			break;
+		}
+	}
+
+	return -1;
+}
+
+void simulation_run(const taskset_t * taskset, unsigned int horizon,
+		simulation_t * simulation)
+{
+	simulation_state_t state;
+	unsigned int now = 0;
+	unsigned int next;
+	unsigned int t;
+	int running;
+
+	memset(&state, 0, sizeof(state));
+	memset(simulation, 0, sizeof(*simulation));
+	state.taskset = taskset;
+	state.simulation = simulation;
+	state.head = -1;
+
+	for (t = 0; t < taskset->task_count; t++)
+	{
+		state.tasks[t].blocked_on = -1;
+		state.tasks[t].priority = taskset->tasks[t].priority;
+		state.tasks[t].next_release = taskset->tasks[t].offset;
+	}
+	for (t = 0; t < TASKSET_MAX_RESOURCES; t++)
+	{
+		state.holders[t] = -1;
+	}
+
+	while (now < horizon)
+	{
+		// Releases at this tick
+		for (t = 0; t < taskset->task_count; t++)
+		{
+			simulation_task_t * sim = &state.tasks[t];
+
+			if (sim->done || sim->next_release != now)
+			{
+				continue;
+			}
+			if (sim->active)
+			{
+				simulation->overruns[t]++;
+				sim->pending = 1;
+			}
+			else
+			{
+				simulation_start_job(&state, t, now);
+			}
+			sim->next_release = (taskset->tasks[t].period > 0) ?
+					now + taskset->tasks[t].period : SIMULATION_NEVER;
+		}
+
+		running = simulation_dispatch(&state, now);
+
+		if (running < 0)
+		{
+			// Idle until the next release, if any
+			next = SIMULATION_NEVER;
+			for (t = 0; t < taskset->task_count; t++)
+			{
+				if (!state.tasks[t].done && state.tasks[t].next_release < next)
+				{
+					next = state.tasks[t].next_release;
+				}
+			}
+			if (next == SIMULATION_NEVER)
+			{
+				break;
+			}
+			now = next;
+			continue;
+		}
+
+		if (--state.tasks[running].remaining == 0)
+		{
+			simulation_next_step(&state, running);
+		}
+		now++;
+	}
+}
@@ -0,0 +1,425 @@
+/*
+ * Response time analysis tool: task set model. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <taskset.h>
+
+#define TASKSET_MAX_LINE		256
+
+static const char * taskset_path;
+static unsigned int taskset_line;
+
+static int taskset_error(const char * message, const char * detail)
+{
+	fprintf(stderr, "%s:%u: %s%s%s\n", taskset_path, taskset_line, message,
+			detail ? ": " : "", detail ? detail : "");
+	return -1;
+}
+
+/** Cuts a line at its comment, if any, outside of quotes */
+static void taskset_strip_comment(char * line)
+{
+	int quoted = 0;
+
+	for (; *line != '\0'; line++)
+	{
+		if (*line == '"')
+		{
+			quoted = !quoted;
+		}
+		else if (*line == '#' && !quoted)
+		{
+			*line = '\0';
+			return;
+		}
+	}
+}
+
+/** Splits the next token of a line. Quoted tokens keep their spaces. */
+static char * taskset_token(char ** cursor)
+{
+	char * start = *cursor + strspn(*cursor, " \t\r\n");
+	char * end;
+
+	if (*start == '\0')
+	{
+		return NULL;
+	}
+
+	if (*start == '"')
+	{
+		start++;
+		end = strchr(start, '"');
+		if (end == NULL)
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		end = start + strcspn(start, " \t\r\n");
+	}
+
+	if (*end != '\0')
+	{
+		*end++ = '\0';
+	}
+	*cursor = end;
+
+	return start;
+}
+
+static int taskset_number(const char * token, unsigned int * value)
+{
+	char * end;
+
+	if (token == NULL)
+	{
+		return -1;
+	}
+
+	*value = (unsigned int) strtoul(token, &end, 10);
+
+	return (*end == '\0') ? 0 : -1;
+}
+
+static int taskset_find_resource(const taskset_t * taskset, const char * name)
+{
+	unsigned int r;
+
+	for (r = 0; r < taskset->resource_count; r++)
+	{
+		if (strcmp(taskset->resources[r].name, name) == 0)
+		{
+			return r;
+		}
+	}
+
+	return -1;
+}
+
+static int taskset_parse_resource(taskset_t * taskset, char * cursor)
+{
+	resource_t * resource;
+	char * name = taskset_token(&cursor);
+	char * protocol = taskset_token(&cursor);
+	char * token;
+
+	if (name == NULL || protocol == NULL)
+	{
+		return taskset_error("expected: resource <name> <protocol>", NULL);
+	}
+	if (taskset->resource_count >= TASKSET_MAX_RESOURCES)
+	{
+		return taskset_error("too many resources", NULL);
+	}
+	if (taskset_find_resource(taskset, name) >= 0)
+	{
+		return taskset_error("duplicated resource", name);
+	}
+
+	resource = &taskset->resources[taskset->resource_count];
+	strncpy(resource->name, name, TASKSET_MAX_NAME - 1);
+	resource->ceiling = 0;
+	resource->priority_queue = 0;
+
+	if (strcmp(protocol, "none") == 0)
+	{
+		resource->protocol = PROTOCOL_NONE;
+	}
+	else if (strcmp(protocol, "inherit") == 0)
+	{
+		resource->protocol = PROTOCOL_INHERIT;
+		resource->priority_queue = 1;
+	}
+	else if (strcmp(protocol, "ceiling") == 0)
+	{
+		resource->protocol = PROTOCOL_CEILING;
+		resource->priority_queue = 1;
+		if (taskset_number(taskset_token(&cursor), &resource->ceiling) != 0)
+		{
+			return taskset_error("expected the ceiling of", name);
+		}
+	}
+	else
+	{
+		return taskset_error("unknown protocol", protocol);
+	}
+
+	while ((token = taskset_token(&cursor)) != NULL)
+	{
+		if (strcmp(token, "fifo") == 0)
+		{
+			resource->priority_queue = 0;
+		}
+		else if (strcmp(token, "priority") == 0)
+		{
+			resource->priority_queue = 1;
+		}
+		else
+		{
+			return taskset_error("unknown resource option", token);
+		}
+	}
+
+	taskset->resource_count++;
+
+	return 0;
+}
+
+static int taskset_parse_task(taskset_t * taskset, char * cursor)
+{
+	task_t * task;
+	char * name = taskset_token(&cursor);
+	char * token;
+	unsigned int * field;
+
+	if (taskset->task_count >= TASKSET_MAX_TASKS)
+	{
+		return taskset_error("too many tasks", NULL);
+	}
+
+	task = &taskset->tasks[taskset->task_count];
+	memset(task, 0, sizeof(*task));
+
+	if (name == NULL || taskset_number(taskset_token(&cursor), &task->priority) != 0)
+	{
+		return taskset_error("expected: task <name> <priority>", NULL);
+	}
+	strncpy(task->name, name, TASKSET_MAX_NAME - 1);
+
+	while ((token = taskset_token(&cursor)) != NULL)
+	{
+		if (strcmp(token, "offset") == 0)
+		{
+			field = &task->offset;
+		}
+		else if (strcmp(token, "period") == 0)
+		{
+			field = &task->period;
+		}
+		else if (strcmp(token, "deadline") == 0)
+		{
+			field = &task->deadline;
+		}
+		else
+		{
+			return taskset_error("unknown task option", token);
+		}
+
+		if (taskset_number(taskset_token(&cursor), field) != 0)
+		{
+			return taskset_error("expected a number after", token);
+		}
+	}
+
+	if (task->deadline == 0)
+	{
+		task->deadline = task->period;
+	}
+
+	return 0;
+}
+
+static int taskset_parse_step(taskset_t * taskset, const char * keyword,
+		char * cursor)
+{
+	task_t * task = &taskset->tasks[taskset->task_count];
+	step_t * step;
+	char * token = taskset_token(&cursor);
+
+	if (task->step_count >= TASKSET_MAX_STEPS)
+	{
+		return taskset_error("too many steps in task", task->name);
+	}
+
+	step = &task->steps[task->step_count];
+	memset(step, 0, sizeof(*step));
+
+	if (strcmp(keyword, "run") == 0)
+	{
+		step->type = STEP_RUN;
+		if (taskset_number(token, &step->ticks) != 0)
+		{
+			return taskset_error("expected: run <ticks>", NULL);
+		}
+	}
+	else if (strcmp(keyword, "lock") == 0 || strcmp(keyword, "unlock") == 0)
+	{
+		step->type = (keyword[0] == 'l') ? STEP_LOCK : STEP_UNLOCK;
+		if (token == NULL ||
+				(step->resource = taskset_find_resource(taskset, token)) < 0)
+		{
+			return taskset_error("unknown resource", token);
+		}
+	}
+	else if (strcmp(keyword, "log") == 0)
+	{
+		step->type = STEP_LOG;
+		if (token == NULL)
+		{
+			return taskset_error("expected: log \"<message>\"", NULL);
+		}
+		strncpy(step->message, token, TASKSET_MAX_MESSAGE - 1);
+	}
+	else
+	{
+		return taskset_error("unknown step", keyword);
+	}
+
+	task->step_count++;
+
+	return 0;
+}
+
+/** Checks that every task releases what it locks, in reverse order */
+static int taskset_check_task(const task_t * task)
+{
+	int held[TASKSET_MAX_STEPS];
+	unsigned int depth = 0;
+	unsigned int s;
+
+	for (s = 0; s < task->step_count; s++)
+	{
+		if (task->steps[s].type == STEP_LOCK)
+		{
+			held[depth++] = task->steps[s].resource;
+		}
+		else if (task->steps[s].type == STEP_UNLOCK)
+		{
+			if (depth == 0 || held[depth - 1] != task->steps[s].resource)
+			{
+				return taskset_error("unlock out of order in task", task->name);
+			}
+			depth--;
+		}
+	}
+
+	if (depth != 0)
+	{
+		return taskset_error("resource not released by task", task->name);
+	}
+
+	return 0;
+}
+
+int taskset_load(taskset_t * taskset, const char * path)
+{
+	char line[TASKSET_MAX_LINE];
+	char * cursor;
+	char * keyword;
+	int in_task = 0;
+	int status = 0;
+	FILE * file;
+
+	memset(taskset, 0, sizeof(*taskset));
+	taskset_path = path;
+	taskset_line = 0;
+
+	file = fopen(path, "r");
+	if (file == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	while (status == 0 && fgets(line, sizeof(line), file) != NULL)
+	{
+		taskset_line++;
+		taskset_strip_comment(line);
+		cursor = line;
+
+		keyword = taskset_token(&cursor);
+		if (keyword == NULL)
+		{
+			continue;
+		}
+
+		if (strcmp(keyword, "end") == 0)
+		{
+			if (!in_task)
+			{
+				status = taskset_error("end without task", NULL);
+			}
+			else if ((status = taskset_check_task(&taskset->tasks[taskset->task_count])) == 0)
+			{
+				taskset->task_count++;
+				in_task = 0;
+			}
+		}
+		else if (in_task)
+		{
+			status = taskset_parse_step(taskset, keyword, cursor);
+		}
+		else if (strcmp(keyword, "resource") == 0)
+		{
+			status = taskset_parse_resource(taskset, cursor);
+		}
+		else if (strcmp(keyword, "task") == 0)
+		{
+			status = taskset_parse_task(taskset, cursor);
+			in_task = 1;
+		}
+		else
+		{
+			status = taskset_error("unknown keyword", keyword);
+		}
+	}
+
+	if (status == 0 && in_task)
+	{
+		status = taskset_error("missing end of task",
+				taskset->tasks[taskset->task_count].name);
+	}
+
+	fclose(file);
+
+	return status;
+}
+
+unsigned int taskset_execution_time(const task_t * task)
+{
+	unsigned int execution = 0;
+	unsigned int s;
+
+	for (s = 0; s < task->step_count; s++)
+	{
+		if (task->steps[s].type == STEP_RUN)
+		{
+			execution += task->steps[s].ticks;
+		}
+	}
+
+	return execution;
+}
+
+const char * taskset_protocol_name(protocol_t protocol)
+{
+	switch (protocol)
+	{
+	case PROTOCOL_INHERIT:
+		return "inherit";
+	case PROTOCOL_CEILING:
+		return "ceiling";
+	default:
+		return "none";
+	}
+}
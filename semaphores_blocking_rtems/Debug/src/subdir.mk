@@ -4,16 +4,40 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/async_log.c \
 ../src/consume_ticks.c \
-../src/main.c 
+../src/cpu_usage.c \
+../src/fastmutex.c \
+../src/fastmutex_bench.c \
+../src/lockprof.c \
+../src/main.c \
+../src/rwlock.c \
+../src/rwlock_bench.c \
+../src/seqlock.c 
 
 OBJS += \
+./src/async_log.o \
 ./src/consume_ticks.o \
-./src/main.o 
+./src/cpu_usage.o \
+./src/fastmutex.o \
+./src/fastmutex_bench.o \
+./src/lockprof.o \
+./src/main.o \
+./src/rwlock.o \
+./src/rwlock_bench.o \
+./src/seqlock.o 
 
 C_DEPS += \
+./src/async_log.d \
 ./src/consume_ticks.d \
-./src/main.d 
+./src/cpu_usage.d \
+./src/fastmutex.d \
+./src/fastmutex_bench.d \
+./src/lockprof.d \
+./src/main.d \
+./src/rwlock.d \
+./src/rwlock_bench.d \
+./src/seqlock.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
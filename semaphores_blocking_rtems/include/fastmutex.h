@@ -0,0 +1,98 @@
+/*
+ * Fast path mutex. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FASTMUTEX_H__
+#define __FASTMUTEX_H__
+
+#include <rtems.h>
+
+/**
+ * Mutex with a fast path for the uncontended case. Taking a free mutex is
+ * a compare and swap of the owner field, and releasing it with nobody
+ * waiting is another one: no directive is called. The processor has no
+ * atomic instructions, so the compare and swap is done with the interrupts
+ * disabled for a few instructions, which is enough on a single processor.
+ *
+ * Only when the mutex is taken does the caller fall back to the kernel:
+ * with RTEMS_INHERIT_PRIORITY it raises the priority of the holder to its
+ * own, and it blocks on a priority ordered RTEMS semaphore. The release
+ * makes the first waiter of that semaphore the holder before waking it up,
+ * so that a task arriving before the new holder runs also raises it, and
+ * restores the priority of the previous holder.
+ *
+ * As with the RTEMS semaphores, the mutex can be obtained again by its
+ * holder, and the raised priority is neither transitive nor restored until
+ * the mutex is released. The priority ceiling protocol is not supported:
+ * it raises the holder on every obtain, which needs a directive call on
+ * the fast path. Use an RTEMS semaphore for it.
+ */
+
+/** Owner of a mutex being handed over to a waiter */
+#define FASTMUTEX_HANDOFF	((rtems_id) 0xFFFFFFFF)
+
+typedef struct {
+
+	/** Holder of the mutex, 0 if free */
+	volatile rtems_id owner;
+	Thread_Control * volatile owner_thread;
+	/** Priority of the holder when it took the mutex */
+	rtems_task_priority owner_priority;
+	uint32_t nest;
+
+	/** Tasks blocked on the kernel semaphore */
+	volatile uint32_t waiters;
+	/** The priority of the holder has been raised */
+	volatile int raised;
+
+	/** RTEMS_INHERIT_PRIORITY or none */
+	rtems_attribute protocol;
+
+	/** Kernel semaphore the waiters block on, and its control block */
+	rtems_id wait_sem;
+	Semaphore_Control * wait_control;
+
+	/** Number of obtains that had to fall back to the kernel */
+	uint32_t contended;
+
+} fastmutex_t;
+
+/**
+ * Creates a mutex. Only the protocol of the attribute set is used.
+ * Returns RTEMS_NOT_DEFINED with RTEMS_PRIORITY_CEILING, or the status of
+ * the creation of the kernel semaphore.
+ */
+rtems_status_code fastmutex_create(fastmutex_t * mutex, rtems_name name,
+		rtems_attribute attribute_set);
+
+/**
+ * Obtains the mutex. The option set is RTEMS_WAIT or RTEMS_NO_WAIT, there
+ * is no timeout. Returns RTEMS_UNSATISFIED if the mutex is taken and
+ * RTEMS_NO_WAIT is given.
+ */
+rtems_status_code fastmutex_obtain(fastmutex_t * mutex, rtems_option option_set);
+
+/**
+ * Releases the mutex. Returns RTEMS_NOT_OWNER_OF_RESOURCE if the caller
+ * does not hold it.
+ */
+rtems_status_code fastmutex_release(fastmutex_t * mutex);
+
+/** Deletes the kernel semaphore of a mutex nobody holds */
+rtems_status_code fastmutex_delete(fastmutex_t * mutex);
+
+#endif // __FASTMUTEX_H__
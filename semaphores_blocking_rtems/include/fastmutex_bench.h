@@ -0,0 +1,50 @@
+/*
+ * Fast path mutex benchmark. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FASTMUTEX_BENCH_H__
+#define __FASTMUTEX_BENCH_H__
+
+#include <rtems.h>
+
+/**
+ * Obtain/release pairs per second of a binary semaphore with priority
+ * inheritance and of a fast path mutex with the same protocol.
+ *
+ * Uncontended: a single task obtains and releases the lock in a loop.
+ * Contended: each iteration the runner takes the lock and wakes up a
+ * higher priority helper with an event. The helper blocks on the lock,
+ * so the release hands it over, and then releases it too. An iteration
+ * is two pairs, one of them contended, and includes the event.
+ */
+
+/** Iterations of the uncontended and contended loops */
+#define FASTMUTEX_BENCH_PAIRS		10000
+#define FASTMUTEX_BENCH_HANDOFFS	2000
+
+/** Priorities of the runner and the helper tasks */
+#define FASTMUTEX_BENCH_PRIORITY	50
+#define FASTMUTEX_BENCH_HELPER_PRIORITY	40
+
+/** Tasks and semaphores created by the benchmark */
+#define FASTMUTEX_BENCH_TASKS		2
+#define FASTMUTEX_BENCH_SEMAPHORES	2
+
+/** Creates the runner task, which prints the results and deletes itself */
+rtems_status_code fastmutex_bench_start(void);
+
+#endif // __FASTMUTEX_BENCH_H__
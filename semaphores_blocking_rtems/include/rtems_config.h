@@ -21,8 +21,38 @@
 
 #include <rtems.h>
 
+#include <cpu_usage.h>
+#include <lockprof.h>
+#include <fastmutex_bench.h>
+#include <rwlock_bench.h>
+
 rtems_task Init(rtems_task_argument arg);
 
+/**
+ * Uncomment to bound the semaphore waits and start the deadlock watchdog
+ * of the lock profiler.
+ */
+// #define DEADLOCK_WATCHDOG
+
+/** Tasks of the deadlock watchdog */
+#ifdef DEADLOCK_WATCHDOG
+#define WATCHDOG_TASKS (1)
+#else
+#define WATCHDOG_TASKS (0)
+#endif
+
+/**
+ * Uncomment to run the fast path mutex benchmark instead of the three
+ * tasks demo.
+ */
+// #define FASTMUTEX_BENCHMARK
+
+/**
+ * Uncomment to run the reader/writer lock benchmark instead of the three
+ * tasks demo.
+ */
+// #define RWLOCK_BENCHMARK
+
 /** Definition of the Console Driver */
 #define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
 
@@ -35,11 +65,31 @@ rtems_task Init(rtems_task_argument arg);
 /** Default value of ticks per timeslice */
 #define CONFIGURE_TICKS_PER_TIMESLICE (50)
 
-// TODO: Define maximum number of semaphores */
-#define MAXIMUM_SEMAPHORES (1);
+#ifdef FASTMUTEX_BENCHMARK
+
+/** Maximum number of semaphores */
+#define CONFIGURE_MAXIMUM_SEMAPHORES (1 + FASTMUTEX_BENCH_SEMAPHORES)
+
+/* Maximum number of tasks */
+#define CONFIGURE_MAXIMUM_TASKS      (4 + FASTMUTEX_BENCH_TASKS + WATCHDOG_TASKS)
+
+#elif defined(RWLOCK_BENCHMARK)
+
+/** Maximum number of semaphores */
+#define CONFIGURE_MAXIMUM_SEMAPHORES (1 + RWLOCK_BENCH_SEMAPHORES)
 
 /* Maximum number of tasks */
-#define CONFIGURE_MAXIMUM_TASKS      (4)
+#define CONFIGURE_MAXIMUM_TASKS      (4 + RWLOCK_BENCH_TASKS + WATCHDOG_TASKS)
+
+#else
+
+/** Maximum number of semaphores */
+#define CONFIGURE_MAXIMUM_SEMAPHORES (1)
+
+/* Maximum number of tasks */
+#define CONFIGURE_MAXIMUM_TASKS      (7 + WATCHDOG_TASKS)
+
+#endif
 
 /**
  * Extra stack memory needed for the tasks. It must include all the memory
@@ -58,6 +108,9 @@ rtems_task Init(rtems_task_argument arg);
                                            RTEMS_NO_TIMESLICE | \
                                            RTEMS_INTERRUPT_LEVEL(0))
 
+/** Per task CPU usage accounting and priority inversion detection */
+#define CONFIGURE_INITIAL_EXTENSIONS CPU_USAGE_EXTENSION, LOCKPROF_EXTENSION
+
 /** Ensure that the default initialization table is defined */
 #define CONFIGURE_RTEMS_INIT_TASKS_TABLE
 
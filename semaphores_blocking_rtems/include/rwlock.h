@@ -0,0 +1,76 @@
+/*
+ * Reader/writer lock. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RWLOCK_H__
+#define __RWLOCK_H__
+
+#include <rtems.h>
+
+/**
+ * Reader/writer lock with writer preference, for data read by many tasks
+ * and written rarely. Any number of readers share the lock; a writer holds
+ * it alone. Once a writer holds or waits for the lock, new readers wait.
+ *
+ * The writers hold a binary semaphore with priority inheritance for their
+ * whole section, and the readers that have to wait do so by obtaining that
+ * semaphore and entering while they hold it: a writer is raised to the
+ * priority of the readers and writers waiting for it, and the waiting
+ * readers enter in priority order with the writers, even if they outrank
+ * them. A writer waiting for the readers to
+ * leave is not: the readers are not known to the kernel, so their sections
+ * must be short. The counters are updated with the interrupts disabled.
+ *
+ * The lock is not recursive: a reader that obtains it again while a writer
+ * waits deadlocks.
+ */
+
+typedef struct {
+
+	/** Readers inside the lock */
+	volatile uint32_t readers;
+	/** Writers holding or waiting for the lock */
+	volatile uint32_t writers;
+	/** A writer waits for the readers to leave */
+	volatile int draining;
+
+	/** Binary inheritance semaphore of the writers */
+	rtems_id writer_sem;
+	/** Counting semaphore the writer waits on for the last reader */
+	rtems_id drain_sem;
+
+} rwlock_t;
+
+/** Creates the semaphores of the lock, named after name and name + 1 */
+rtems_status_code rwlock_create(rwlock_t * lock, rtems_name name);
+
+/** Deletes the semaphores of the lock */
+rtems_status_code rwlock_delete(rwlock_t * lock);
+
+/** Obtains the lock for reading, waiting for the writers if needed */
+rtems_status_code rwlock_read_obtain(rwlock_t * lock);
+
+/** Releases a read lock */
+rtems_status_code rwlock_read_release(rwlock_t * lock);
+
+/** Obtains the lock for writing, waiting for the readers to leave */
+rtems_status_code rwlock_write_obtain(rwlock_t * lock);
+
+/** Releases a write lock */
+rtems_status_code rwlock_write_release(rwlock_t * lock);
+
+#endif // __RWLOCK_H__
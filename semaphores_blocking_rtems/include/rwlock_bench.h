@@ -0,0 +1,64 @@
+/*
+ * Reader/writer lock benchmark. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RWLOCK_BENCH_H__
+#define __RWLOCK_BENCH_H__
+
+#include <rtems.h>
+
+/**
+ * Reader throughput of a state vector protected by a binary semaphore
+ * with priority inheritance, a reader/writer lock and a sequence lock,
+ * with one to RWLOCK_BENCH_MAX_READERS reader tasks.
+ *
+ * The readers share a priority and are time sliced, so that some of them
+ * are preempted inside the lock. A higher priority writer updates the
+ * state every RWLOCK_BENCH_WRITE_PERIOD ticks. Every copy is checked, and
+ * the torn reads, which must be zero, are reported with the reads per
+ * second of all the readers together.
+ *
+ * A last pass, with RWLOCK_BENCH_MAX_READERS readers, lowers the writer
+ * below the readers, as with fast readers of attitude data. The readers
+ * then sleep a tick every RWLOCK_BENCH_READ_BURST reads to leave the CPU
+ * to the writer; its writes show that the readers never lock it out.
+ */
+
+/** Number of readers of the last run */
+#define RWLOCK_BENCH_MAX_READERS	8
+
+/** Length of each run and period of the writer, in ticks */
+#define RWLOCK_BENCH_RUN_TICKS		200
+#define RWLOCK_BENCH_WRITE_PERIOD	5
+
+/** Priorities of the runner, the writer and the readers */
+#define RWLOCK_BENCH_PRIORITY		40
+#define RWLOCK_BENCH_WRITER_PRIORITY	45
+#define RWLOCK_BENCH_READER_PRIORITY	60
+
+/** Priority of the writer and reads per tick when the readers outrank it */
+#define RWLOCK_BENCH_LOW_WRITER_PRIORITY	70
+#define RWLOCK_BENCH_READ_BURST		64
+
+/** Tasks and semaphores created by the benchmark */
+#define RWLOCK_BENCH_TASKS		(2 + RWLOCK_BENCH_MAX_READERS)
+#define RWLOCK_BENCH_SEMAPHORES	5
+
+/** Creates the tasks, which print the results and delete themselves */
+rtems_status_code rwlock_bench_start(void);
+
+#endif // __RWLOCK_BENCH_H__
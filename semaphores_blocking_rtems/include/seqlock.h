@@ -0,0 +1,73 @@
+/*
+ * Sequence lock. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SEQLOCK_H__
+#define __SEQLOCK_H__
+
+#include <rtems.h>
+
+/**
+ * Sequence lock for small structures without pointers, such as a state
+ * vector. Writers hold a binary inheritance semaphore and increment the
+ * sequence number before and after the update, so it is odd while the data
+ * is being changed. Readers take no lock: they copy the data and retry if
+ * the sequence number was odd or has changed meanwhile.
+ *
+ * On a single processor a reader can only see an update in progress if it
+ * preempted the writer, so spinning would never let the writer finish. In
+ * that case only, the reader waits for the writer on its semaphore, which
+ * raises the writer to the priority of the reader.
+ */
+
+typedef struct {
+
+	volatile uint32_t sequence;
+	rtems_id writer_sem;
+
+} seqlock_t;
+
+/** Creates the semaphore of the writers */
+rtems_status_code seqlock_create(seqlock_t * lock, rtems_name name);
+
+/** Deletes the semaphore of the writers */
+rtems_status_code seqlock_delete(seqlock_t * lock);
+
+/** Starts a read, returning the sequence number to check at the end */
+uint32_t seqlock_read_begin(seqlock_t * lock);
+
+/**
+ * Ends a read. Returns 0 if the data read is consistent, or 1 if the read
+ * must be done again, after waiting for the writer if it was preempted.
+ */
+int seqlock_read_retry(seqlock_t * lock, uint32_t sequence);
+
+/** Starts an update, waiting for the other writers */
+rtems_status_code seqlock_write_begin(seqlock_t * lock);
+
+/** Ends an update */
+rtems_status_code seqlock_write_end(seqlock_t * lock);
+
+/** Reads a consistent copy of size bytes at data into copy */
+void seqlock_read(seqlock_t * lock, void * copy, const void * data,
+		size_t size);
+
+/** Updates the size bytes at data with the ones at value */
+rtems_status_code seqlock_write(seqlock_t * lock, void * data,
+		const void * value, size_t size);
+
+#endif // __SEQLOCK_H__
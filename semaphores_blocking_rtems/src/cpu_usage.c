@@ -0,0 +1,170 @@
+/*
+ * CPU usage accounting. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <cpu_usage.h>
+
+typedef struct {
+
+	/** Last thread charged in this slot */
+	rtems_id id;
+	/** CPU time, in microseconds */
+	uint64_t time_us;
+
+} cpu_usage_slot_t;
+
+/** Classic API tasks, then the idle thread and then any other thread */
+#define CPU_USAGE_IDLE		(CPU_USAGE_MAX_TASKS)
+#define CPU_USAGE_OTHER		(CPU_USAGE_MAX_TASKS + 1)
+#define CPU_USAGE_SLOTS		(CPU_USAGE_MAX_TASKS + 2)
+
+/** Updated only by the task switch extension */
+static cpu_usage_slot_t cpu_usage_slots[CPU_USAGE_SLOTS];
+
+/** Uptime of the last task switch */
+static uint32_t cpu_usage_last_us = 0;
+
+/** Accumulated times at the previous report */
+static uint64_t cpu_usage_reported_us[CPU_USAGE_SLOTS];
+
+static rtems_id cpu_usage_task_id;
+
+static inline uint32_t cpu_usage_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+void cpu_usage_switch(Thread_Control * executing, Thread_Control * heir)
+{
+	uint32_t now_us = cpu_usage_uptime_us();
+	rtems_id id = executing->Object.id;
+	unsigned int slot;
+
+	if (executing == _Thread_Idle)
+	{
+		slot = CPU_USAGE_IDLE;
+	}
+	else if (_Objects_Get_API(id) == OBJECTS_CLASSIC_API &&
+			rtems_get_index(id) < CPU_USAGE_MAX_TASKS)
+	{
+		slot = rtems_get_index(id);
+	}
+	else
+	{
+		slot = CPU_USAGE_OTHER;
+	}
+
+	cpu_usage_slots[slot].id = id;
+	cpu_usage_slots[slot].time_us += now_us - cpu_usage_last_us;
+	cpu_usage_last_us = now_us;
+}
+
+/** Prints a line of the report, with the usage in tenths of percent */
+static void cpu_usage_print(const char * name, rtems_id id, uint64_t time_us,
+		uint64_t total_us)
+{
+	uint32_t permille = (uint32_t)((time_us * 1000 + total_us / 2) / total_us);
+
+	printf("  %-6s 0x%08lX %10lu us %3lu.%lu%%\n", name, (unsigned long) id,
+			(unsigned long) time_us, (unsigned long)(permille / 10),
+			(unsigned long)(permille % 10));
+}
+
+void cpu_usage_report(void)
+{
+	rtems_interrupt_level level;
+	uint64_t current_us[CPU_USAGE_SLOTS];
+	uint64_t delta_us[CPU_USAGE_SLOTS];
+	uint64_t total_us = 0;
+	int i;
+
+	// The extension runs on task switches, which cannot happen while the
+	// interrupts are disabled
+	rtems_interrupt_disable(level);
+	for (i = 0; i < CPU_USAGE_SLOTS; i++)
+	{
+		current_us[i] = cpu_usage_slots[i].time_us;
+	}
+	rtems_interrupt_enable(level);
+
+	for (i = 0; i < CPU_USAGE_SLOTS; i++)
+	{
+		delta_us[i] = current_us[i] - cpu_usage_reported_us[i];
+		cpu_usage_reported_us[i] = current_us[i];
+		total_us += delta_us[i];
+	}
+
+	if (total_us == 0)
+	{
+		return;
+	}
+
+	printf("CPU USAGE over %lu us\n", (unsigned long) total_us);
+
+	for (i = 0; i < CPU_USAGE_MAX_TASKS; i++)
+	{
+		if (delta_us[i] != 0)
+		{
+			cpu_usage_print("TASK", cpu_usage_slots[i].id, delta_us[i], total_us);
+		}
+	}
+	if (delta_us[CPU_USAGE_OTHER] != 0)
+	{
+		cpu_usage_print("OTHER", cpu_usage_slots[CPU_USAGE_OTHER].id,
+				delta_us[CPU_USAGE_OTHER], total_us);
+	}
+	cpu_usage_print("IDLE", cpu_usage_slots[CPU_USAGE_IDLE].id,
+			delta_us[CPU_USAGE_IDLE], total_us);
+}
+
+static rtems_task cpu_usage_task(rtems_task_argument argument)
+{
+	rtems_interval period = (rtems_interval) argument;
+
+	for (;;)
+	{
+		rtems_task_wake_after(period);
+
+		cpu_usage_report();
+	}
+}
+
+rtems_status_code cpu_usage_init(rtems_task_priority priority,
+		rtems_interval period)
+{
+	rtems_status_code status;
+
+	status = rtems_task_create(rtems_build_name('C', 'P', 'U', 'U'),
+			priority, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &cpu_usage_task_id);
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_task_start(cpu_usage_task_id, cpu_usage_task,
+			(rtems_task_argument) period);
+}
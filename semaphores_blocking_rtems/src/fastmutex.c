@@ -0,0 +1,243 @@
+/*
+ * Fast path mutex. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <fastmutex.h>
+
+/**
+ * Makes a task the holder of the mutex. Its priority is saved before the
+ * holder thread is published: a waiter that finds the holder may raise it,
+ * and rtems_task_set_priority() also changes its real priority.
+ */
+static inline void fastmutex_set_owner(fastmutex_t * mutex,
+		Thread_Control * thread)
+{
+	mutex->owner_priority = thread->real_priority;
+	mutex->nest = 1;
+	mutex->owner_thread = thread;
+	mutex->owner = thread->Object.id;
+}
+
+/**
+ * Compare and swap of the owner: takes the mutex if it is free. The
+ * holder thread is set in the same step, so that a waiter that preempts
+ * the new holder right after always finds it.
+ */
+static inline int fastmutex_take(fastmutex_t * mutex, Thread_Control * executing)
+{
+	rtems_interrupt_level level;
+	int taken = 0;
+
+	rtems_interrupt_disable(level);
+	if (mutex->owner == 0)
+	{
+		fastmutex_set_owner(mutex, executing);
+		taken = 1;
+	}
+	rtems_interrupt_enable(level);
+
+	return taken;
+}
+
+rtems_status_code fastmutex_create(fastmutex_t * mutex, rtems_name name,
+		rtems_attribute attribute_set)
+{
+	Objects_Locations location;
+	rtems_status_code status;
+
+	if (attribute_set & RTEMS_PRIORITY_CEILING)
+	{
+		return RTEMS_NOT_DEFINED;
+	}
+
+	mutex->owner = 0;
+	mutex->owner_thread = NULL;
+	mutex->owner_priority = 0;
+	mutex->nest = 0;
+	mutex->waiters = 0;
+	mutex->raised = 0;
+	mutex->protocol = attribute_set & RTEMS_INHERIT_PRIORITY;
+	mutex->contended = 0;
+
+	// The waiters block on it until the holder hands the mutex over
+	status = rtems_semaphore_create(name, 0,
+			RTEMS_COUNTING_SEMAPHORE | RTEMS_PRIORITY, 0, &mutex->wait_sem);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	// The release looks at its wait queue to know the next holder
+	mutex->wait_control = (Semaphore_Control *)
+			_Objects_Get(&_Semaphore_Information, mutex->wait_sem, &location);
+	if (location != OBJECTS_LOCAL)
+	{
+		return RTEMS_INVALID_ID;
+	}
+	_Thread_Enable_dispatch();
+
+	return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code fastmutex_obtain(fastmutex_t * mutex, rtems_option option_set)
+{
+	Thread_Control * executing = _Thread_Executing;
+	Thread_Control * holder;
+	rtems_task_priority old_priority;
+	rtems_interrupt_level level;
+	rtems_status_code status;
+
+	// Fast path: the mutex is free, or the caller already holds it
+	if (fastmutex_take(mutex, executing))
+	{
+		return RTEMS_SUCCESSFUL;
+	}
+	if (mutex->owner == executing->Object.id)
+	{
+		mutex->nest++;
+		return RTEMS_SUCCESSFUL;
+	}
+
+	if (option_set & RTEMS_NO_WAIT)
+	{
+		return RTEMS_UNSATISFIED;
+	}
+
+	// Slow path. With the dispatching disabled the holder cannot release
+	// the mutex while the caller registers as a waiter and raises it.
+	_Thread_Disable_dispatch();
+
+	if (fastmutex_take(mutex, executing))
+	{
+		_Thread_Enable_dispatch();
+		return RTEMS_SUCCESSFUL;
+	}
+
+	mutex->waiters++;
+	mutex->contended++;
+
+	// The holder is NULL only while the mutex is handed over to a waiter
+	// that had not blocked yet. It runs before any task of lower priority
+	// and takes the mutex as soon as it does, so it needs no raise.
+	holder = mutex->owner_thread;
+	if (mutex->protocol != 0 && holder != NULL &&
+			holder->current_priority > executing->current_priority)
+	{
+		mutex->raised = 1;
+		rtems_task_set_priority(holder->Object.id,
+				executing->current_priority, &old_priority);
+	}
+
+	_Thread_Enable_dispatch();
+
+	status = rtems_semaphore_obtain(mutex->wait_sem, RTEMS_WAIT,
+			RTEMS_NO_TIMEOUT);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	// Handed over by the previous holder, which made the caller the holder
+	// already unless the caller had not blocked yet
+	rtems_interrupt_disable(level);
+	if (mutex->owner != executing->Object.id)
+	{
+		fastmutex_set_owner(mutex, executing);
+	}
+	rtems_interrupt_enable(level);
+
+	return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code fastmutex_release(fastmutex_t * mutex)
+{
+	rtems_interrupt_level level;
+	rtems_task_priority priority;
+	rtems_task_priority old_priority;
+	Thread_Control * next;
+	int raised;
+
+	if (mutex->owner != _Thread_Executing->Object.id)
+	{
+		return RTEMS_NOT_OWNER_OF_RESOURCE;
+	}
+
+	if (--mutex->nest > 0)
+	{
+		return RTEMS_SUCCESSFUL;
+	}
+
+	// Fast path: nobody waits
+	rtems_interrupt_disable(level);
+	if (mutex->waiters == 0)
+	{
+		mutex->owner_thread = NULL;
+		mutex->owner = 0;
+		rtems_interrupt_enable(level);
+		return RTEMS_SUCCESSFUL;
+	}
+	rtems_interrupt_enable(level);
+
+	// With the dispatching disabled no other waiter can block before the
+	// one at the head of the wait queue is woken up
+	_Thread_Disable_dispatch();
+
+	mutex->waiters--;
+	raised = mutex->raised;
+	mutex->raised = 0;
+	priority = mutex->owner_priority;
+
+	// The waiter that the release wakes up is the new holder, so that the
+	// tasks that arrive before it runs raise it. A waiter that has not
+	// blocked yet takes the mutex by itself.
+	next = _Thread_queue_First(
+			&mutex->wait_control->Core_control.semaphore.Wait_queue);
+	if (next != NULL)
+	{
+		fastmutex_set_owner(mutex, next);
+	}
+	else
+	{
+		mutex->owner_thread = NULL;
+		mutex->owner = FASTMUTEX_HANDOFF;
+	}
+
+	// The waiter does not preempt the caller until its priority is
+	// restored, as it was raised to the waiter's
+	rtems_semaphore_release(mutex->wait_sem);
+
+	_Thread_Enable_dispatch();
+
+	if (raised)
+	{
+		rtems_task_set_priority(RTEMS_SELF, priority, &old_priority);
+	}
+
+	return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code fastmutex_delete(fastmutex_t * mutex)
+{
+	if (mutex->owner != 0)
+	{
+		return RTEMS_RESOURCE_IN_USE;
+	}
+
+	return rtems_semaphore_delete(mutex->wait_sem);
+}
@@ -0,0 +1,192 @@
+/*
+ * Fast path mutex benchmark. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <fastmutex.h>
+#include <fastmutex_bench.h>
+
+/** Lock under test */
+typedef enum {
+	FASTMUTEX_BENCH_SEMAPHORE,
+	FASTMUTEX_BENCH_FASTMUTEX
+} fastmutex_bench_lock_t;
+
+static const char * fastmutex_bench_names[] = { "semaphore", "fastmutex" };
+
+static rtems_id fastmutex_bench_sem;
+static fastmutex_t fastmutex_bench_mutex;
+
+static volatile fastmutex_bench_lock_t fastmutex_bench_lock;
+
+static rtems_id fastmutex_bench_helper_id;
+
+static uint32_t fastmutex_bench_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+static inline void fastmutex_bench_obtain(fastmutex_bench_lock_t lock)
+{
+	if (lock == FASTMUTEX_BENCH_SEMAPHORE)
+	{
+		rtems_semaphore_obtain(fastmutex_bench_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+	}
+	else
+	{
+		fastmutex_obtain(&fastmutex_bench_mutex, RTEMS_WAIT);
+	}
+}
+
+static inline void fastmutex_bench_release(fastmutex_bench_lock_t lock)
+{
+	if (lock == FASTMUTEX_BENCH_SEMAPHORE)
+	{
+		rtems_semaphore_release(fastmutex_bench_sem);
+	}
+	else
+	{
+		fastmutex_release(&fastmutex_bench_mutex);
+	}
+}
+
+static void fastmutex_bench_print(const char * test, fastmutex_bench_lock_t lock,
+		uint32_t pairs, uint32_t elapsed_us)
+{
+	if (elapsed_us == 0)
+	{
+		elapsed_us = 1;
+	}
+
+	printf("  %-11s %-9s %6lu pairs in %8lu us: %8lu pairs/s\n", test,
+			fastmutex_bench_names[lock], (unsigned long) pairs,
+			(unsigned long) elapsed_us,
+			(unsigned long) ((uint64_t) pairs * 1000000 / elapsed_us));
+}
+
+static void fastmutex_bench_uncontended(fastmutex_bench_lock_t lock)
+{
+	uint32_t start_us;
+	uint32_t i;
+
+	start_us = fastmutex_bench_uptime_us();
+	for (i = 0; i < FASTMUTEX_BENCH_PAIRS; i++)
+	{
+		fastmutex_bench_obtain(lock);
+		fastmutex_bench_release(lock);
+	}
+
+	fastmutex_bench_print("uncontended", lock, FASTMUTEX_BENCH_PAIRS,
+			fastmutex_bench_uptime_us() - start_us);
+}
+
+static void fastmutex_bench_contended(fastmutex_bench_lock_t lock)
+{
+	uint32_t start_us;
+	uint32_t i;
+
+	fastmutex_bench_lock = lock;
+
+	start_us = fastmutex_bench_uptime_us();
+	for (i = 0; i < FASTMUTEX_BENCH_HANDOFFS; i++)
+	{
+		fastmutex_bench_obtain(lock);
+		// The helper preempts the runner and blocks on the lock
+		rtems_event_send(fastmutex_bench_helper_id, RTEMS_EVENT_0);
+		fastmutex_bench_release(lock);
+	}
+
+	fastmutex_bench_print("contended", lock, 2 * FASTMUTEX_BENCH_HANDOFFS,
+			fastmutex_bench_uptime_us() - start_us);
+}
+
+static rtems_task fastmutex_bench_helper(rtems_task_argument argument)
+{
+	rtems_event_set events;
+
+	for (;;)
+	{
+		rtems_event_receive(RTEMS_EVENT_0, RTEMS_EVENT_ANY, RTEMS_NO_TIMEOUT,
+				&events);
+		fastmutex_bench_obtain(fastmutex_bench_lock);
+		fastmutex_bench_release(fastmutex_bench_lock);
+	}
+}
+
+static rtems_task fastmutex_bench_runner(rtems_task_argument argument)
+{
+	printf("FASTMUTEX BENCHMARK\n");
+
+	fastmutex_bench_uncontended(FASTMUTEX_BENCH_SEMAPHORE);
+	fastmutex_bench_uncontended(FASTMUTEX_BENCH_FASTMUTEX);
+	fastmutex_bench_contended(FASTMUTEX_BENCH_SEMAPHORE);
+	fastmutex_bench_contended(FASTMUTEX_BENCH_FASTMUTEX);
+
+	printf("  fastmutex fell back to the kernel %lu times\n",
+			(unsigned long) fastmutex_bench_mutex.contended);
+
+	rtems_task_delete(fastmutex_bench_helper_id);
+	rtems_task_delete(RTEMS_SELF);
+}
+
+rtems_status_code fastmutex_bench_start(void)
+{
+	rtems_status_code status;
+	rtems_id runner_id;
+
+	status = rtems_semaphore_create(rtems_build_name('B','S','e','m'), 1,
+			RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY | RTEMS_INHERIT_PRIORITY,
+			0, &fastmutex_bench_sem);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	status = fastmutex_create(&fastmutex_bench_mutex,
+			rtems_build_name('B','F','m','x'), RTEMS_INHERIT_PRIORITY);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	status = rtems_task_create(rtems_build_name('B','H','l','p'),
+			FASTMUTEX_BENCH_HELPER_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &fastmutex_bench_helper_id);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+	rtems_task_start(fastmutex_bench_helper_id, fastmutex_bench_helper, 0);
+
+	status = rtems_task_create(rtems_build_name('B','R','u','n'),
+			FASTMUTEX_BENCH_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &runner_id);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_task_start(runner_id, fastmutex_bench_runner, 0);
+}
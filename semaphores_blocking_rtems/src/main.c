@@ -24,16 +24,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <async_log.h>
+
 #define PRINT(fmt,args...)  printf ( fmt "\n",\
                             ##args)
 
-#define PRINT_TIME(fmt,args...) do { \
-			unsigned int __current_tick; \
-			rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &__current_tick); \
-			printf ("%lu: " fmt "\n", __current_tick, ##args); \
-			} while (0)
+#define PRINT_TIME(fmt,args...) LOG_TIME(fmt "\n", ##args)
 
 #include <consume_ticks.h>
+#include <lockprof.h>
+#include <fastmutex_bench.h>
+#include <rwlock_bench.h>
 
 /** The one and only semaphore */
 rtems_id critical_section_sem;
@@ -47,11 +48,11 @@ rtems_task T1(rtems_task_argument argument)
 	PRINT_TIME("STARTING T1");
 	consume_ticks(4);
 	PRINT_TIME("TRYING TO OBTAIN SEMAPHORE T1") ;
-	rtems_semaphore_obtain(critical_section_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+	lockprof_obtain(critical_section_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
 	PRINT_TIME("OBTAINED SEMAPHORE T1") ;
 	consume_ticks(3);
 	PRINT_TIME("RELEASING SEMAPHORE T1") ;
-	rtems_semaphore_release(critical_section_sem);
+	lockprof_release(critical_section_sem);
 	consume_ticks(2);
 	PRINT_TIME("FINISHING T1") ;
 	rtems_task_delete(RTEMS_SELF);
@@ -74,10 +75,10 @@ rtems_task T3(rtems_task_argument argument)
 	PRINT_TIME("STARTING T3") ;
 	consume_ticks(6);
 	PRINT_TIME("TRYING TO OBTAIN SEMAPHORE T3") ;
-	rtems_semaphore_obtain(critical_section_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+	lockprof_obtain(critical_section_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
 	consume_ticks(10);
 	PRINT_TIME("RELEASING SEMAPHORE T3") ;
-	rtems_semaphore_release(critical_section_sem);
+	lockprof_release(critical_section_sem);
 	consume_ticks(4);
 	PRINT_TIME("FINISHING T3") ;
 	rtems_task_delete(RTEMS_SELF);
@@ -86,12 +87,36 @@ rtems_task T3(rtems_task_argument argument)
 
 rtems_task Init(rtems_task_argument arg)
 {
+#if !defined(FASTMUTEX_BENCHMARK) && !defined(RWLOCK_BENCHMARK)
 	rtems_id T1_id;
 	rtems_id T2_id;
 	rtems_id T3_id;
+#endif
+
+	// Calibrate the busy work against the clock, before any task runs
+	consume_calibrate();
+
+	// Start the asynchronous logging drain task
+	log_init(LOG_DRAIN_PRIORITY);
+
+	// Start the CPU usage reporter
+	cpu_usage_init(CPU_USAGE_REPORT_PRIORITY, CPU_USAGE_REPORT_PERIOD);
+
+	// Start the lock profile reporter
+	lockprof_init();
+
+#ifdef DEADLOCK_WATCHDOG
+	// Bound the semaphore waits and look for deadlocks
+	lockprof_watchdog_init();
+#endif
 
+#ifdef FASTMUTEX_BENCHMARK
+	fastmutex_bench_start();
+#elif defined(RWLOCK_BENCHMARK)
+	rwlock_bench_start();
+#else
 	// TODO: Create the semaphore
-	rtems_semaphore_create(rtems_build_name('S','e','m','1'),1,RTEMS_BINARY_SEMAPHORE, 0, &critical_section_sem);
+	lockprof_semaphore_create("Sem1", rtems_build_name('S','e','m','1'),1,RTEMS_BINARY_SEMAPHORE, 0, &critical_section_sem);
 
 	// Create T1
 	rtems_task_create(rtems_build_name('T', 'S', 'K', '1'),
@@ -119,6 +144,7 @@ rtems_task Init(rtems_task_argument arg)
 
 	// Start T3 task
 	rtems_task_start(T3_id, T3, 0);
+#endif
 
 	/** Delete the initial task from the system */
 	rtems_task_delete(RTEMS_SELF);
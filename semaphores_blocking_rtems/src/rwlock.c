@@ -0,0 +1,160 @@
+/*
+ * Reader/writer lock. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <rwlock.h>
+
+rtems_status_code rwlock_create(rwlock_t * lock, rtems_name name)
+{
+	rtems_status_code status;
+
+	lock->readers = 0;
+	lock->writers = 0;
+	lock->draining = 0;
+
+	status = rtems_semaphore_create(name, 1,
+			RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY | RTEMS_INHERIT_PRIORITY,
+			0, &lock->writer_sem);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_semaphore_create(name + 1, 0,
+			RTEMS_COUNTING_SEMAPHORE | RTEMS_PRIORITY, 0, &lock->drain_sem);
+}
+
+rtems_status_code rwlock_delete(rwlock_t * lock)
+{
+	rtems_status_code status;
+
+	status = rtems_semaphore_delete(lock->writer_sem);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_semaphore_delete(lock->drain_sem);
+}
+
+rtems_status_code rwlock_read_obtain(rwlock_t * lock)
+{
+	rtems_interrupt_level level;
+	rtems_status_code status;
+
+	rtems_interrupt_disable(level);
+	if (lock->writers == 0)
+	{
+		lock->readers++;
+		rtems_interrupt_enable(level);
+		return RTEMS_SUCCESSFUL;
+	}
+	rtems_interrupt_enable(level);
+
+	/*
+	 * Wait behind the writer, raising its priority. A writer is always
+	 * inside its section with writer_sem held, so once the reader holds it
+	 * no writer is, and it can enter: a writer that obtains writer_sem
+	 * later on finds it among the readers and waits for it. Entering
+	 * without checking writers again, instead of retrying, keeps a reader
+	 * with a higher priority than a writer that has counted itself but not
+	 * obtained writer_sem yet from looping forever over a free semaphore.
+	 */
+	status = rtems_semaphore_obtain(lock->writer_sem, RTEMS_WAIT,
+			RTEMS_NO_TIMEOUT);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	rtems_interrupt_disable(level);
+	lock->readers++;
+	rtems_interrupt_enable(level);
+
+	return rtems_semaphore_release(lock->writer_sem);
+}
+
+rtems_status_code rwlock_read_release(rwlock_t * lock)
+{
+	rtems_interrupt_level level;
+	int last;
+
+	rtems_interrupt_disable(level);
+	lock->readers--;
+	last = lock->readers == 0 && lock->draining;
+	if (last)
+	{
+		lock->draining = 0;
+	}
+	rtems_interrupt_enable(level);
+
+	if (last)
+	{
+		return rtems_semaphore_release(lock->drain_sem);
+	}
+
+	return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code rwlock_write_obtain(rwlock_t * lock)
+{
+	rtems_interrupt_level level;
+	rtems_status_code status;
+	int drain;
+
+	// From now on, new readers wait
+	rtems_interrupt_disable(level);
+	lock->writers++;
+	rtems_interrupt_enable(level);
+
+	status = rtems_semaphore_obtain(lock->writer_sem, RTEMS_WAIT,
+			RTEMS_NO_TIMEOUT);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		rtems_interrupt_disable(level);
+		lock->writers--;
+		rtems_interrupt_enable(level);
+		return status;
+	}
+
+	rtems_interrupt_disable(level);
+	drain = lock->readers > 0;
+	lock->draining = drain;
+	rtems_interrupt_enable(level);
+
+	if (drain)
+	{
+		// The last reader to leave releases it
+		return rtems_semaphore_obtain(lock->drain_sem, RTEMS_WAIT,
+				RTEMS_NO_TIMEOUT);
+	}
+
+	return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code rwlock_write_release(rwlock_t * lock)
+{
+	rtems_interrupt_level level;
+
+	rtems_interrupt_disable(level);
+	lock->writers--;
+	rtems_interrupt_enable(level);
+
+	return rtems_semaphore_release(lock->writer_sem);
+}
@@ -0,0 +1,351 @@
+/*
+ * Reader/writer lock benchmark. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rwlock.h>
+#include <seqlock.h>
+#include <rwlock_bench.h>
+
+/** Lock under test */
+typedef enum {
+	RWLOCK_BENCH_SEMAPHORE,
+	RWLOCK_BENCH_RWLOCK,
+	RWLOCK_BENCH_SEQLOCK,
+	RWLOCK_BENCH_LOCKS
+} rwlock_bench_lock_t;
+
+static const char * rwlock_bench_names[] = { "semaphore", "rwlock", "seqlock" };
+
+/** Attitude like state: every field holds the number of the last update */
+typedef struct {
+
+	uint32_t quaternion[4];
+	uint32_t rates[3];
+	uint32_t time;
+
+} rwlock_bench_state_t;
+
+static rwlock_bench_state_t rwlock_bench_state;
+
+static rtems_id rwlock_bench_sem;
+static rwlock_t rwlock_bench_rwlock;
+static seqlock_t rwlock_bench_seqlock;
+
+/** Released by the writer and the readers when a run ends */
+static rtems_id rwlock_bench_done_sem;
+
+static volatile rwlock_bench_lock_t rwlock_bench_lock;
+static volatile int rwlock_bench_running;
+
+/** The readers outrank the writer and sleep between bursts of reads */
+static volatile int rwlock_bench_readers_first = 0;
+
+static volatile uint32_t rwlock_bench_reads[RWLOCK_BENCH_MAX_READERS];
+static volatile uint32_t rwlock_bench_torn[RWLOCK_BENCH_MAX_READERS];
+static volatile uint32_t rwlock_bench_writes;
+
+static rtems_id rwlock_bench_reader_ids[RWLOCK_BENCH_MAX_READERS];
+static rtems_id rwlock_bench_writer_id;
+
+static uint32_t rwlock_bench_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+static void rwlock_bench_fill(rwlock_bench_state_t * state, uint32_t value)
+{
+	unsigned int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		state->quaternion[i] = value;
+	}
+	for (i = 0; i < 3; i++)
+	{
+		state->rates[i] = value;
+	}
+	state->time = value;
+}
+
+static int rwlock_bench_consistent(const rwlock_bench_state_t * state)
+{
+	rwlock_bench_state_t expected;
+
+	rwlock_bench_fill(&expected, state->time);
+
+	return memcmp(&expected, state, sizeof(expected)) == 0;
+}
+
+static void rwlock_bench_read(rwlock_bench_lock_t lock,
+		rwlock_bench_state_t * copy)
+{
+	switch (lock)
+	{
+	case RWLOCK_BENCH_SEMAPHORE:
+		rtems_semaphore_obtain(rwlock_bench_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		*copy = rwlock_bench_state;
+		rtems_semaphore_release(rwlock_bench_sem);
+		break;
+	case RWLOCK_BENCH_RWLOCK:
+		rwlock_read_obtain(&rwlock_bench_rwlock);
+		*copy = rwlock_bench_state;
+		rwlock_read_release(&rwlock_bench_rwlock);
+		break;
+	default:
+		seqlock_read(&rwlock_bench_seqlock, copy, &rwlock_bench_state,
+				sizeof(*copy));
+		break;
+	}
+}
+
+static void rwlock_bench_write(rwlock_bench_lock_t lock, uint32_t value)
+{
+	switch (lock)
+	{
+	case RWLOCK_BENCH_SEMAPHORE:
+		rtems_semaphore_obtain(rwlock_bench_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		rwlock_bench_fill(&rwlock_bench_state, value);
+		rtems_semaphore_release(rwlock_bench_sem);
+		break;
+	case RWLOCK_BENCH_RWLOCK:
+		rwlock_write_obtain(&rwlock_bench_rwlock);
+		rwlock_bench_fill(&rwlock_bench_state, value);
+		rwlock_write_release(&rwlock_bench_rwlock);
+		break;
+	default:
+		seqlock_write_begin(&rwlock_bench_seqlock);
+		rwlock_bench_fill(&rwlock_bench_state, value);
+		seqlock_write_end(&rwlock_bench_seqlock);
+		break;
+	}
+}
+
+static rtems_task rwlock_bench_reader(rtems_task_argument argument)
+{
+	rwlock_bench_state_t copy;
+	rtems_event_set events;
+
+	for (;;)
+	{
+		rtems_event_receive(RTEMS_EVENT_0, RTEMS_EVENT_ANY, RTEMS_NO_TIMEOUT,
+				&events);
+
+		while (rwlock_bench_running)
+		{
+			rwlock_bench_read(rwlock_bench_lock, &copy);
+			if (!rwlock_bench_consistent(&copy))
+			{
+				rwlock_bench_torn[argument]++;
+			}
+			rwlock_bench_reads[argument]++;
+
+			if (rwlock_bench_readers_first && (rwlock_bench_reads[argument]
+					% RWLOCK_BENCH_READ_BURST) == 0)
+			{
+				rtems_task_wake_after(1);
+			}
+		}
+
+		rtems_semaphore_release(rwlock_bench_done_sem);
+	}
+}
+
+static rtems_task rwlock_bench_writer(rtems_task_argument argument)
+{
+	rtems_event_set events;
+	uint32_t value = 0;
+
+	for (;;)
+	{
+		rtems_event_receive(RTEMS_EVENT_0, RTEMS_EVENT_ANY, RTEMS_NO_TIMEOUT,
+				&events);
+
+		for (;;)
+		{
+			rtems_task_wake_after(RWLOCK_BENCH_WRITE_PERIOD);
+			if (!rwlock_bench_running)
+			{
+				break;
+			}
+			rwlock_bench_write(rwlock_bench_lock, ++value);
+			rwlock_bench_writes++;
+		}
+
+		rtems_semaphore_release(rwlock_bench_done_sem);
+	}
+}
+
+static void rwlock_bench_run(rwlock_bench_lock_t lock, unsigned int readers)
+{
+	uint32_t start_us, elapsed_us;
+	uint32_t reads = 0, torn = 0;
+	unsigned int i;
+
+	rwlock_bench_lock = lock;
+	rwlock_bench_writes = 0;
+	for (i = 0; i < readers; i++)
+	{
+		rwlock_bench_reads[i] = 0;
+		rwlock_bench_torn[i] = 0;
+	}
+
+	rwlock_bench_running = 1;
+	start_us = rwlock_bench_uptime_us();
+	rtems_event_send(rwlock_bench_writer_id, RTEMS_EVENT_0);
+	for (i = 0; i < readers; i++)
+	{
+		rtems_event_send(rwlock_bench_reader_ids[i], RTEMS_EVENT_0);
+	}
+
+	rtems_task_wake_after(RWLOCK_BENCH_RUN_TICKS);
+	rwlock_bench_running = 0;
+	elapsed_us = rwlock_bench_uptime_us() - start_us;
+
+	// Wait for the writer and the readers to leave the lock
+	for (i = 0; i < readers + 1; i++)
+	{
+		rtems_semaphore_obtain(rwlock_bench_done_sem, RTEMS_WAIT,
+				RTEMS_NO_TIMEOUT);
+	}
+
+	for (i = 0; i < readers; i++)
+	{
+		reads += rwlock_bench_reads[i];
+		torn += rwlock_bench_torn[i];
+	}
+
+	printf("  %-9s %u readers: %8lu reads/s, %4lu writes, %lu torn\n",
+			rwlock_bench_names[lock], readers,
+			(unsigned long) ((uint64_t) reads * 1000000 / elapsed_us),
+			(unsigned long) rwlock_bench_writes, (unsigned long) torn);
+}
+
+static rtems_task rwlock_bench_runner(rtems_task_argument argument)
+{
+	rtems_task_priority old_priority;
+	rwlock_bench_lock_t lock;
+	unsigned int readers;
+	unsigned int i;
+
+	printf("RWLOCK BENCHMARK\n");
+
+	for (lock = 0; lock < RWLOCK_BENCH_LOCKS; lock++)
+	{
+		for (readers = 1; readers <= RWLOCK_BENCH_MAX_READERS; readers++)
+		{
+			rwlock_bench_run(lock, readers);
+		}
+	}
+
+	printf("Readers outrank the writer\n");
+	rtems_task_set_priority(rwlock_bench_writer_id,
+			RWLOCK_BENCH_LOW_WRITER_PRIORITY, &old_priority);
+	rwlock_bench_readers_first = 1;
+	for (lock = 0; lock < RWLOCK_BENCH_LOCKS; lock++)
+	{
+		rwlock_bench_run(lock, RWLOCK_BENCH_MAX_READERS);
+	}
+
+	for (i = 0; i < RWLOCK_BENCH_MAX_READERS; i++)
+	{
+		rtems_task_delete(rwlock_bench_reader_ids[i]);
+	}
+	rtems_task_delete(rwlock_bench_writer_id);
+	rtems_task_delete(RTEMS_SELF);
+}
+
+rtems_status_code rwlock_bench_start(void)
+{
+	rtems_status_code status;
+	rtems_id runner_id;
+	unsigned int i;
+
+	status = rtems_semaphore_create(rtems_build_name('R','S','e','m'), 1,
+			RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY | RTEMS_INHERIT_PRIORITY,
+			0, &rwlock_bench_sem);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	status = rwlock_create(&rwlock_bench_rwlock,
+			rtems_build_name('R','W','L','0'));
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	status = seqlock_create(&rwlock_bench_seqlock,
+			rtems_build_name('S','Q','L','K'));
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	status = rtems_semaphore_create(rtems_build_name('R','D','o','n'), 0,
+			RTEMS_COUNTING_SEMAPHORE | RTEMS_PRIORITY, 0,
+			&rwlock_bench_done_sem);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	rwlock_bench_fill(&rwlock_bench_state, 0);
+
+	status = rtems_task_create(rtems_build_name('R','W','r','t'),
+			RWLOCK_BENCH_WRITER_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &rwlock_bench_writer_id);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+	rtems_task_start(rwlock_bench_writer_id, rwlock_bench_writer, 0);
+
+	// The readers are time sliced, to be preempted inside the lock
+	for (i = 0; i < RWLOCK_BENCH_MAX_READERS; i++)
+	{
+		status = rtems_task_create(rtems_build_name('R','d','r','0' + i),
+				RWLOCK_BENCH_READER_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+				RTEMS_PREEMPT | RTEMS_TIMESLICE,
+				RTEMS_DEFAULT_ATTRIBUTES, &rwlock_bench_reader_ids[i]);
+		if (status != RTEMS_SUCCESSFUL)
+		{
+			return status;
+		}
+		rtems_task_start(rwlock_bench_reader_ids[i], rwlock_bench_reader, i);
+	}
+
+	status = rtems_task_create(rtems_build_name('R','R','u','n'),
+			RWLOCK_BENCH_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &runner_id);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_task_start(runner_id, rwlock_bench_runner, 0);
+}
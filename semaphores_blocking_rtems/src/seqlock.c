@@ -0,0 +1,120 @@
+/*
+ * Sequence lock. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <string.h>
+
+#include <seqlock.h>
+
+/** Compiler barrier: the data is accessed between the sequence updates */
+#define SEQLOCK_BARRIER() __asm__ __volatile__ ("" : : : "memory")
+
+rtems_status_code seqlock_create(seqlock_t * lock, rtems_name name)
+{
+	lock->sequence = 0;
+
+	return rtems_semaphore_create(name, 1,
+			RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY | RTEMS_INHERIT_PRIORITY,
+			0, &lock->writer_sem);
+}
+
+rtems_status_code seqlock_delete(seqlock_t * lock)
+{
+	return rtems_semaphore_delete(lock->writer_sem);
+}
+
+uint32_t seqlock_read_begin(seqlock_t * lock)
+{
+	uint32_t sequence = lock->sequence;
+
+	SEQLOCK_BARRIER();
+
+	return sequence;
+}
+
+int seqlock_read_retry(seqlock_t * lock, uint32_t sequence)
+{
+	SEQLOCK_BARRIER();
+
+	if (!(sequence & 1) && lock->sequence == sequence)
+	{
+		return 0;
+	}
+
+	if (lock->sequence & 1)
+	{
+		// The reader preempted a writer: let it finish
+		rtems_semaphore_obtain(lock->writer_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		rtems_semaphore_release(lock->writer_sem);
+	}
+
+	return 1;
+}
+
+rtems_status_code seqlock_write_begin(seqlock_t * lock)
+{
+	rtems_status_code status;
+
+	status = rtems_semaphore_obtain(lock->writer_sem, RTEMS_WAIT,
+			RTEMS_NO_TIMEOUT);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	lock->sequence++;
+	SEQLOCK_BARRIER();
+
+	return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code seqlock_write_end(seqlock_t * lock)
+{
+	SEQLOCK_BARRIER();
+	lock->sequence++;
+
+	return rtems_semaphore_release(lock->writer_sem);
+}
+
+void seqlock_read(seqlock_t * lock, void * copy, const void * data,
+		size_t size)
+{
+	uint32_t sequence;
+
+	do
+	{
+		sequence = seqlock_read_begin(lock);
+		memcpy(copy, data, size);
+	} while (seqlock_read_retry(lock, sequence));
+}
+
+rtems_status_code seqlock_write(seqlock_t * lock, void * data,
+		const void * value, size_t size)
+{
+	rtems_status_code status;
+
+	status = seqlock_write_begin(lock);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	memcpy(data, value, size);
+
+	return seqlock_write_end(lock);
+}
@@ -0,0 +1,49 @@
+/*
+ * Consume Ticks helper function. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CONSUME_TICKS_H__
+#define __CONSUME_TICKS_H__
+
+#include <rtems.h>
+
+/** Number of ticks spent by consume_calibrate() */
+#define CONSUME_CALIBRATION_TICKS	10
+
+/**
+ * Occupies the CPU for the given number of ticks. Once calibrated, it
+ * burns ticks * CONFIGURE_MICROSECONDS_PER_TICK microseconds of CPU time
+ * of the calling task, as consume_cpu_us() does. Before the calibration,
+ * it waits for the given number of tick edges, preempted time included.
+ */
+void consume_ticks(uint32_t ticks);
+
+/**
+ * Measures the speed of the busy loop against the clock. It must be
+ * called from Init, before any other task is started, and it takes
+ * CONSUME_CALIBRATION_TICKS ticks.
+ */
+void consume_calibrate(void);
+
+/**
+ * Burns the given number of microseconds of CPU time of the calling task.
+ * The time the task is preempted is not counted. Without calibration, it
+ * falls back to consume_ticks() rounded up to whole ticks.
+ */
+void consume_cpu_us(uint32_t us);
+
+#endif // __CONSUME_TICKS_H__
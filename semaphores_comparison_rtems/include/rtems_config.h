@@ -0,0 +1,67 @@
+/*
+ * Semaphore Protocols Comparison RTEMS Project. Configuration file.
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RTEMS_CONFIG_H__
+#define __RTEMS_CONFIG_H__
+
+#include <rtems.h>
+
+#include <scenario.h>
+
+rtems_task Init(rtems_task_argument arg);
+
+/** Definition of the Console Driver */
+#define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
+
+/** Definition of the Clock Driver */
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+
+/** Default value of microseconds per tick */
+#define CONFIGURE_MICROSECONDS_PER_TICK	(10000)
+
+/** Default value of ticks per timeslice */
+#define CONFIGURE_TICKS_PER_TIMESLICE (50)
+
+/** Maximum number of semaphores */
+#define CONFIGURE_MAXIMUM_SEMAPHORES (SCENARIO_MAX_RESOURCES)
+
+/** Maximum number of tasks: Init, the runner and the scenario tasks */
+#define CONFIGURE_MAXIMUM_TASKS      (2 + SCENARIO_MAX_TASKS)
+
+/** 16 KB should be enough :) */
+#define CONFIGURE_INIT_TASK_STACK_SIZE	   (4 * RTEMS_MINIMUM_STACK_SIZE)
+
+/** Default Init task priority: maximum */
+#define CONFIGURE_INIT_TASK_PRIORITY       1
+
+/** Default initial task modes */
+#define CONFIGURE_INIT_TASK_INITIAL_MODES (RTEMS_NO_PREEMPT | \
+                                           RTEMS_NO_TIMESLICE | \
+                                           RTEMS_INTERRUPT_LEVEL(0))
+
+/** Dispatch counting of the scenario tasks */
+#define CONFIGURE_INITIAL_EXTENSIONS SCENARIO_EXTENSION
+
+/** Ensure that the default initialization table is defined */
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
+
+#endif /* __RTEMS_CONFIG_H__ */
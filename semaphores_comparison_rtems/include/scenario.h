@@ -0,0 +1,106 @@
+/*
+ * Semaphore protocols scenario runner. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SCENARIO_H__
+#define __SCENARIO_H__
+
+#include <rtems.h>
+
+/**
+ * Runs the same task set once per semaphore protocol (none, priority
+ * inheritance and priority ceiling) in a single boot, and prints a table
+ * that compares, for every task and protocol:
+ *
+ *  - the response time, from the release of the task (offset ticks after
+ *    the start of the run, whether or not it gets the CPU then) to its end;
+ *  - the time waiting in rtems_semaphore_obtain();
+ *  - the delay, the response time minus the CPU time of the task, which
+ *    adds the preemptions and every kind of blocking (with the ceiling
+ *    protocol a task is blocked before it even tries to obtain);
+ *  - the number of times the task was dispatched.
+ *
+ * Each task is a list of steps, as in the T1/T2/T3 demos. The ceiling of
+ * every semaphore is the priority of its highest priority user.
+ */
+
+/** Maximum number of tasks and semaphores of a scenario */
+#define SCENARIO_MAX_TASKS			8
+#define SCENARIO_MAX_RESOURCES		4
+
+/** Priority of the runner task, above every scenario task */
+#define SCENARIO_RUNNER_PRIORITY	2
+
+/** Ticks between two runs, for the console to drain */
+#define SCENARIO_GAP_TICKS			20
+
+typedef enum {
+	SCENARIO_RUN,		/**< Consume the given number of ticks */
+	SCENARIO_LOCK,		/**< Obtain the given semaphore */
+	SCENARIO_UNLOCK,	/**< Release the given semaphore */
+	SCENARIO_END
+} scenario_op_t;
+
+typedef struct {
+
+	scenario_op_t op;
+	uint32_t arg;
+
+} scenario_step_t;
+
+typedef struct {
+
+	const char * name;
+	rtems_task_priority priority;
+	/** Release, in ticks from the start of the run */
+	rtems_interval offset;
+	const scenario_step_t * steps;
+
+} scenario_task_t;
+
+typedef struct {
+
+	const char * name;
+	const scenario_task_t * tasks;
+	unsigned int task_count;
+	unsigned int resource_count;
+
+} scenario_t;
+
+/** Task switch extension. Use SCENARIO_EXTENSION instead. */
+void scenario_switch(Thread_Control * executing, Thread_Control * heir);
+
+/** User extensions table entry that counts the dispatches of the tasks */
+#define SCENARIO_EXTENSION { \
+		NULL,				/* task create */ \
+		NULL,				/* task start */ \
+		NULL,				/* task restart */ \
+		NULL,				/* task delete */ \
+		scenario_switch,	/* task switch */ \
+		NULL,				/* task begin */ \
+		NULL,				/* task exitted */ \
+		NULL				/* fatal */ \
+		}
+
+/**
+ * Creates the runner task, which runs each scenario under every protocol
+ * and prints its comparison. It must be called from Init.
+ */
+rtems_status_code scenario_start(const scenario_t * scenarios,
+		unsigned int count);
+
+#endif // __SCENARIO_H__
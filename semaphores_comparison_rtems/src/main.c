@@ -0,0 +1,110 @@
+/*
+ * Semaphore Protocols Comparison RTEMS Project
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+
+#include <rtems_config.h>
+
+/** Luckily, we have the libc! :) */
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PRINT(fmt,args...)  printf ( fmt "\n",\
+                            ##args)
+
+#include <consume_ticks.h>
+#include <scenario.h>
+
+/**
+ * T1/T2/T3 with one semaphore, as in semaphores_blocking_rtems and
+ * semaphores_priority_inheritance_rtems: T2 preempts T3 while it holds
+ * the semaphore T1 waits for.
+ */
+static const scenario_step_t one_sem_T1[] = {
+	{ SCENARIO_RUN, 4 }, { SCENARIO_LOCK, 0 }, { SCENARIO_RUN, 3 },
+	{ SCENARIO_UNLOCK, 0 }, { SCENARIO_RUN, 2 }, { SCENARIO_END, 0 }
+};
+
+static const scenario_step_t one_sem_T2[] = {
+	{ SCENARIO_RUN, 7 }, { SCENARIO_END, 0 }
+};
+
+static const scenario_step_t one_sem_T3[] = {
+	{ SCENARIO_RUN, 6 }, { SCENARIO_LOCK, 0 }, { SCENARIO_RUN, 10 },
+	{ SCENARIO_UNLOCK, 0 }, { SCENARIO_RUN, 4 }, { SCENARIO_END, 0 }
+};
+
+static const scenario_task_t one_sem_tasks[] = {
+	{ "T1", 10, 8, one_sem_T1 },
+	{ "T2", 15, 15, one_sem_T2 },
+	{ "T3", 20, 0, one_sem_T3 }
+};
+
+/**
+ * T1/T2/T3 with two semaphores, as in semaphores_nested_rtems and
+ * semaphores_priority_ceiling_rtems.
+ */
+static const scenario_step_t two_sems_T1[] = {
+	{ SCENARIO_RUN, 4 }, { SCENARIO_LOCK, 0 }, { SCENARIO_RUN, 3 },
+	{ SCENARIO_UNLOCK, 0 }, { SCENARIO_RUN, 2 }, { SCENARIO_LOCK, 1 },
+	{ SCENARIO_RUN, 2 }, { SCENARIO_UNLOCK, 1 }, { SCENARIO_RUN, 2 },
+	{ SCENARIO_END, 0 }
+};
+
+static const scenario_step_t two_sems_T2[] = {
+	{ SCENARIO_RUN, 2 }, { SCENARIO_LOCK, 1 }, { SCENARIO_RUN, 4 },
+	{ SCENARIO_UNLOCK, 1 }, { SCENARIO_RUN, 3 }, { SCENARIO_END, 0 }
+};
+
+static const scenario_step_t two_sems_T3[] = {
+	{ SCENARIO_RUN, 6 }, { SCENARIO_LOCK, 0 }, { SCENARIO_RUN, 6 },
+	{ SCENARIO_UNLOCK, 0 }, { SCENARIO_RUN, 2 }, { SCENARIO_END, 0 }
+};
+
+static const scenario_task_t two_sems_tasks[] = {
+	{ "T1", 10, 12, two_sems_T1 },
+	{ "T2", 15, 8, two_sems_T2 },
+	{ "T3", 20, 0, two_sems_T3 }
+};
+
+static const scenario_t scenarios[] = {
+	{ "one semaphore", one_sem_tasks,
+			sizeof(one_sem_tasks) / sizeof(one_sem_tasks[0]), 1 },
+	{ "two semaphores", two_sems_tasks,
+			sizeof(two_sems_tasks) / sizeof(two_sems_tasks[0]), 2 }
+};
+
+
+rtems_task Init(rtems_task_argument arg)
+{
+	rtems_status_code status;
+
+	// Calibrate the busy work against the clock, before any task runs
+	consume_calibrate();
+
+	// Run every scenario under the three protocols
+	status = scenario_start(scenarios, sizeof(scenarios) / sizeof(scenarios[0]));
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		PRINT("Cannot start the scenarios: %d", status);
+	}
+
+	/** Delete the initial task from the system */
+	rtems_task_delete(RTEMS_SELF);
+
+}
@@ -0,0 +1,309 @@
+/*
+ * Semaphore protocols scenario runner. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <consume_ticks.h>
+#include <scenario.h>
+
+typedef struct {
+
+	const char * name;
+	rtems_attribute attribute_set;
+
+} scenario_protocol_t;
+
+static const scenario_protocol_t scenario_protocols[] = {
+	{ "none",		RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY },
+	{ "inherit",	RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY | RTEMS_INHERIT_PRIORITY },
+	{ "ceiling",	RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY | RTEMS_PRIORITY_CEILING }
+};
+
+#define SCENARIO_PROTOCOLS \
+		(sizeof(scenario_protocols) / sizeof(scenario_protocols[0]))
+
+typedef struct {
+
+	/** Times, in microseconds */
+	uint32_t response_us;
+	uint32_t wait_us;
+	uint32_t demand_us;
+	uint32_t dispatches;
+
+} scenario_result_t;
+
+static scenario_result_t scenario_results[SCENARIO_PROTOCOLS][SCENARIO_MAX_TASKS];
+
+/** Scenarios to run, and the one running */
+static const scenario_t * scenario_list;
+static unsigned int scenario_count;
+static const scenario_t * scenario_current = NULL;
+static unsigned int scenario_protocol;
+
+static rtems_id scenario_semaphores[SCENARIO_MAX_RESOURCES];
+
+/** Start of the current run, from which the tasks are released */
+static rtems_interval scenario_start_tick;
+static uint32_t scenario_start_us;
+
+/** Tasks of the current run, 0 when there is no run */
+static rtems_id scenario_ids[SCENARIO_MAX_TASKS];
+static volatile uint32_t scenario_dispatches[SCENARIO_MAX_TASKS];
+
+static rtems_id scenario_runner_id;
+
+static uint32_t scenario_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+void scenario_switch(Thread_Control * executing, Thread_Control * heir)
+{
+	unsigned int i;
+
+	if (scenario_current == NULL)
+	{
+		return;
+	}
+
+	for (i = 0; i < scenario_current->task_count; i++)
+	{
+		if (scenario_ids[i] == heir->Object.id)
+		{
+			scenario_dispatches[i]++;
+			return;
+		}
+	}
+}
+
+/** Priority of the highest priority user of the resource */
+static rtems_task_priority scenario_ceiling(const scenario_t * scenario,
+		uint32_t resource)
+{
+	rtems_task_priority ceiling = RTEMS_MAXIMUM_PRIORITY;
+	const scenario_step_t * step;
+	unsigned int i;
+
+	for (i = 0; i < scenario->task_count; i++)
+	{
+		for (step = scenario->tasks[i].steps; step->op != SCENARIO_END; step++)
+		{
+			if (step->op == SCENARIO_LOCK && step->arg == resource &&
+					scenario->tasks[i].priority < ceiling)
+			{
+				ceiling = scenario->tasks[i].priority;
+			}
+		}
+	}
+
+	return ceiling;
+}
+
+static rtems_task scenario_task(rtems_task_argument argument)
+{
+	const scenario_task_t * task = &scenario_current->tasks[argument];
+	scenario_result_t * result = &scenario_results[scenario_protocol][argument];
+	uint32_t us_per_tick = rtems_configuration_get_microseconds_per_tick();
+	const scenario_step_t * step;
+	uint32_t release_us, start_us;
+	rtems_interval tick;
+
+	// The release is the nominal one: the time the task waits for the CPU
+	// once released is part of its response (e.g. behind a task running at
+	// the ceiling), and it does not shift the release of the later tasks
+	release_us = scenario_start_us + task->offset * us_per_tick;
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &tick);
+	if (tick - scenario_start_tick < task->offset)
+	{
+		rtems_task_wake_after(task->offset - (tick - scenario_start_tick));
+	}
+
+	for (step = task->steps; step->op != SCENARIO_END; step++)
+	{
+		switch (step->op)
+		{
+		case SCENARIO_RUN:
+			consume_ticks(step->arg);
+			result->demand_us += step->arg * us_per_tick;
+			break;
+		case SCENARIO_LOCK:
+			start_us = scenario_uptime_us();
+			rtems_semaphore_obtain(scenario_semaphores[step->arg], RTEMS_WAIT,
+					RTEMS_NO_TIMEOUT);
+			result->wait_us += scenario_uptime_us() - start_us;
+			break;
+		case SCENARIO_UNLOCK:
+			rtems_semaphore_release(scenario_semaphores[step->arg]);
+			break;
+		default:
+			break;
+		}
+	}
+
+	result->response_us = scenario_uptime_us() - release_us;
+
+	rtems_event_send(scenario_runner_id, 1u << argument);
+	rtems_task_delete(RTEMS_SELF);
+}
+
+static void scenario_run(const scenario_t * scenario, unsigned int protocol)
+{
+	rtems_event_set events;
+	unsigned int i;
+
+	for (i = 0; i < scenario->resource_count; i++)
+	{
+		rtems_semaphore_create(rtems_build_name('S', 'C', 'S', '0' + i), 1,
+				scenario_protocols[protocol].attribute_set,
+				scenario_ceiling(scenario, i), &scenario_semaphores[i]);
+	}
+
+	scenario_protocol = protocol;
+	for (i = 0; i < scenario->task_count; i++)
+	{
+		scenario_results[protocol][i].response_us = 0;
+		scenario_results[protocol][i].wait_us = 0;
+		scenario_results[protocol][i].demand_us = 0;
+		scenario_dispatches[i] = 0;
+		rtems_task_create(rtems_build_name('S', 'C', 'T', '0' + i),
+				scenario->tasks[i].priority, RTEMS_MINIMUM_STACK_SIZE,
+				RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+				RTEMS_DEFAULT_ATTRIBUTES, &scenario_ids[i]);
+	}
+
+	// Start the run at the beginning of a tick, so that the releases fall
+	// on the ticks. The tasks run once the runner waits.
+	rtems_task_wake_after(1);
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &scenario_start_tick);
+	scenario_start_us = scenario_uptime_us();
+
+	for (i = 0; i < scenario->task_count; i++)
+	{
+		rtems_task_start(scenario_ids[i], scenario_task, i);
+	}
+
+	rtems_event_receive((1u << scenario->task_count) - 1, RTEMS_EVENT_ALL,
+			RTEMS_NO_TIMEOUT, &events);
+
+	for (i = 0; i < scenario->task_count; i++)
+	{
+		scenario_results[protocol][i].dispatches = scenario_dispatches[i];
+		scenario_ids[i] = 0;
+	}
+
+	for (i = 0; i < scenario->resource_count; i++)
+	{
+		rtems_semaphore_delete(scenario_semaphores[i]);
+	}
+}
+
+static void scenario_print(const scenario_t * scenario)
+{
+	const scenario_result_t * result;
+	uint32_t delay_us;
+	unsigned int i, protocol;
+
+	printf("PROTOCOL COMPARISON: %s (times in ms)\n", scenario->name);
+
+	printf("%-6s %4s", "task", "prio");
+	for (protocol = 0; protocol < SCENARIO_PROTOCOLS; protocol++)
+	{
+		printf(" | %-7s %5s %5s %5s %4s", scenario_protocols[protocol].name,
+				"resp", "wait", "delay", "disp");
+	}
+	printf("\n");
+
+	for (i = 0; i < scenario->task_count; i++)
+	{
+		printf("%-6s %4lu", scenario->tasks[i].name,
+				(unsigned long) scenario->tasks[i].priority);
+		for (protocol = 0; protocol < SCENARIO_PROTOCOLS; protocol++)
+		{
+			result = &scenario_results[protocol][i];
+			// With the calibration jitter, a task may take a bit less CPU
+			// time than its demand
+			delay_us = (result->response_us > result->demand_us) ?
+					result->response_us - result->demand_us : 0;
+			printf(" | %-7s %5lu %5lu %5lu %4lu", "",
+					(unsigned long) result->response_us / 1000,
+					(unsigned long) result->wait_us / 1000,
+					(unsigned long) delay_us / 1000,
+					(unsigned long) result->dispatches);
+		}
+		printf("\n");
+	}
+}
+
+static rtems_task scenario_runner(rtems_task_argument argument)
+{
+	unsigned int protocol;
+	unsigned int i;
+
+	for (i = 0; i < scenario_count; i++)
+	{
+		scenario_current = &scenario_list[i];
+
+		for (protocol = 0; protocol < SCENARIO_PROTOCOLS; protocol++)
+		{
+			scenario_run(scenario_current, protocol);
+			rtems_task_wake_after(SCENARIO_GAP_TICKS);
+		}
+
+		scenario_current = NULL;
+		scenario_print(&scenario_list[i]);
+		rtems_task_wake_after(SCENARIO_GAP_TICKS);
+	}
+
+	rtems_task_delete(RTEMS_SELF);
+}
+
+rtems_status_code scenario_start(const scenario_t * scenarios,
+		unsigned int count)
+{
+	rtems_status_code status;
+	unsigned int i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (scenarios[i].task_count > SCENARIO_MAX_TASKS ||
+				scenarios[i].resource_count > SCENARIO_MAX_RESOURCES)
+		{
+			return RTEMS_TOO_MANY;
+		}
+	}
+
+	scenario_list = scenarios;
+	scenario_count = count;
+
+	status = rtems_task_create(rtems_build_name('S', 'C', 'R', 'N'),
+			SCENARIO_RUNNER_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &scenario_runner_id);
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_task_start(scenario_runner_id, scenario_runner, 0);
+}
@@ -4,15 +4,27 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/async_log.c \
 ../src/consume_ticks.c \
+../src/cpu_usage.c \
+../src/lockcheck.c \
+../src/lockprof.c \
 ../src/main.c 
 
 OBJS += \
+./src/async_log.o \
 ./src/consume_ticks.o \
+./src/cpu_usage.o \
+./src/lockcheck.o \
+./src/lockprof.o \
 ./src/main.o 
 
 C_DEPS += \
+./src/async_log.d \
 ./src/consume_ticks.d \
+./src/cpu_usage.d \
+./src/lockcheck.d \
+./src/lockprof.d \
 ./src/main.d 
 
 
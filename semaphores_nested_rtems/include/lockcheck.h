@@ -0,0 +1,91 @@
+/*
+ * Lock usage checker. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LOCKCHECK_H__
+#define __LOCKCHECK_H__
+
+#include <rtems.h>
+
+/**
+ * Boot time checker of the semaphore usage. The tasks, the semaphores and
+ * which task obtains which semaphore while holding which others are
+ * declared in tables. Before the semaphores are created, the checker:
+ *
+ *  - computes the ceiling of every semaphore as the priority of its
+ *    highest priority user. A declared ceiling above it blocks tasks that
+ *    never use the semaphore; one below it makes the obtain fail.
+ *  - builds the lock order graph (an edge from every held semaphore to the
+ *    one obtained) and reports a cycle for each back edge its depth first
+ *    search finds, as each one is a possible deadlock. The graph has a
+ *    cycle if and only if one is reported, but cycles that share edges
+ *    with a reported one may not be listed.
+ */
+
+/** Maximum number of semaphores, one bit each in the held bitmaps */
+#define LOCKCHECK_MAX_RESOURCES		32
+
+typedef struct {
+
+	const char * name;
+	rtems_task_priority priority;
+
+} lockcheck_task_t;
+
+typedef struct {
+
+	const char * name;
+	/** RTEMS_PRIORITY_CEILING, RTEMS_INHERIT_PRIORITY or none */
+	rtems_attribute protocol;
+	/** Declared ceiling, 0 to take the computed one */
+	rtems_task_priority ceiling;
+
+} lockcheck_resource_t;
+
+typedef struct {
+
+	/** Indexes in the task and resource tables */
+	unsigned int task;
+	unsigned int resource;
+	/** Bitmap of the resources held when the resource is obtained */
+	uint32_t held;
+
+} lockcheck_use_t;
+
+typedef struct {
+
+	const lockcheck_task_t * tasks;
+	unsigned int task_count;
+	const lockcheck_resource_t * resources;
+	unsigned int resource_count;
+	const lockcheck_use_t * uses;
+	unsigned int use_count;
+
+} lockcheck_config_t;
+
+/**
+ * Checks the configuration and prints the findings. The ceilings to create
+ * the semaphores with (the declared one if any, the computed one otherwise)
+ * are stored in ceilings, one per resource. Returns the number of errors:
+ * ceilings below a user, lock order cycles reported and invalid table
+ * entries.
+ * Ceilings above the highest user are only warned about.
+ */
+unsigned int lockcheck_verify(const lockcheck_config_t * config,
+		rtems_task_priority ceilings[]);
+
+#endif // __LOCKCHECK_H__
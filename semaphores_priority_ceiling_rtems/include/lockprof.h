@@ -0,0 +1,164 @@
+/*
+ * Lock contention profiler. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LOCKPROF_H__
+#define __LOCKPROF_H__
+
+#include <rtems.h>
+
+/**
+ * Lock contention profiler. The wrappers below replace the semaphore
+ * directives and keep, per semaphore, the number of acquisitions, how
+ * many of them had to wait, the total and maximum wait and hold times,
+ * and the tasks involved in the worst cases. An uncontended obtain costs
+ * one directive call as before: the wrapper first tries without waiting
+ * and only waits, measuring the time, if the semaphore is taken.
+ *
+ * A low priority reporter task prints the statistics whenever they change.
+ *
+ * The profiler also detects priority inversions: while a task waits for a
+ * semaphore, a task switch extension checks whether the CPU is given to a
+ * task of lower priority than the waiter other than the holder (e.g. a
+ * medium priority task that preempts the holder). The holder is read from
+ * the semaphore of the kernel at every switch, since the owner kept by the
+ * wrappers lags behind the obtains and handovers. The time spent in that
+ * state is the length of the inversion, recorded with its chain: waiter,
+ * holder and preemptor. Install LOCKPROF_EXTENSION in rtems_config.h.
+ *
+ * Optionally, a deadlock watchdog bounds the obtains without a timeout:
+ * they wait in slices of LOCKPROF_WATCHDOG_SLICE ticks, so that a task
+ * waiting longer than a slice is known to be stuck for a while. A monitor
+ * task follows the wait-for graph of those tasks (waiter -> holder of the
+ * semaphore it waits for) and prints every cycle in one line, with the
+ * semaphores and how long they have been held.
+ */
+
+/** Maximum number of profiled semaphores */
+#define LOCKPROF_MAX_SEMAPHORES		8
+
+/** Tasks that can be tracked while waiting, indexed by object index */
+#define LOCKPROF_MAX_WAITERS		16
+
+/** Priority of the reporter task */
+#define LOCKPROF_REPORT_PRIORITY	247
+
+/** Period, in ticks, of the reporter task */
+#define LOCKPROF_REPORT_PERIOD		100
+
+/** Length, in ticks, of each wait of the obtains in watchdog mode */
+#define LOCKPROF_WATCHDOG_SLICE		10
+
+/** Priority of the deadlock monitor task */
+#define LOCKPROF_WATCHDOG_PRIORITY	246
+
+/** Period, in ticks, of the deadlock monitor task */
+#define LOCKPROF_WATCHDOG_PERIOD	50
+
+typedef struct {
+
+	rtems_id id;
+	const char * name;
+
+	/** Number of obtains, and how many of them had to wait */
+	uint32_t acquisitions;
+	uint32_t contended;
+
+	/** Wait and hold times, in microseconds */
+	uint64_t total_wait_us;
+	uint32_t max_wait_us;
+	uint64_t total_hold_us;
+	uint32_t max_hold_us;
+
+	/** Tasks of the longest wait: the waiter and the holder it waited for */
+	rtems_id max_wait_task;
+	rtems_id max_wait_holder;
+	/** Task of the longest hold */
+	rtems_id max_hold_task;
+
+	/** Current holder, nesting level and time of the outermost obtain */
+	rtems_id owner;
+	uint32_t nest;
+	uint32_t acquired_us;
+
+} lockprof_t;
+
+typedef struct {
+
+	/** Number of waits with an inversion and their total length */
+	uint32_t count;
+	uint64_t total_us;
+
+	/** Longest inversion and its blocking chain */
+	uint32_t max_us;
+	rtems_id max_semaphore;
+	rtems_id max_waiter;
+	rtems_id max_holder;
+	rtems_id max_preemptor;
+
+} lockprof_inversions_t;
+
+/**
+ * Creates a semaphore as rtems_semaphore_create() does and registers it
+ * with the given name for the reports. It must be called from Init.
+ */
+rtems_status_code lockprof_semaphore_create(const char * name,
+		rtems_name rtems_name, uint32_t count, rtems_attribute attribute_set,
+		rtems_task_priority priority_ceiling, rtems_id * id);
+
+/** Profiled rtems_semaphore_obtain() */
+rtems_status_code lockprof_obtain(rtems_id id, rtems_option option_set,
+		rtems_interval timeout);
+
+/** Profiled rtems_semaphore_release() */
+rtems_status_code lockprof_release(rtems_id id);
+
+/** Returns the profile of a semaphore, or NULL if it is not registered */
+const lockprof_t * lockprof_get(rtems_id id);
+
+/** Copies the priority inversion statistics */
+void lockprof_get_inversions(lockprof_inversions_t * inversions);
+
+/** Task switch extension. Use LOCKPROF_EXTENSION instead. */
+void lockprof_switch(Thread_Control * executing, Thread_Control * heir);
+
+/** User extensions table entry of the priority inversion detector */
+#define LOCKPROF_EXTENSION { \
+		NULL,				/* task create */ \
+		NULL,				/* task start */ \
+		NULL,				/* task restart */ \
+		NULL,				/* task delete */ \
+		lockprof_switch,	/* task switch */ \
+		NULL,				/* task begin */ \
+		NULL,				/* task exitted */ \
+		NULL				/* fatal */ \
+		}
+
+/** Prints the statistics of all the semaphores */
+void lockprof_report(void);
+
+/** Creates and starts the reporter task. It must be called from Init. */
+rtems_status_code lockprof_init(void);
+
+/**
+ * Enables the deadlock watchdog and starts its monitor task. It must be
+ * called from Init. A task that waits in slices may lose its place among
+ * the waiters of the same priority on every slice.
+ */
+rtems_status_code lockprof_watchdog_init(void);
+
+#endif // __LOCKPROF_H__
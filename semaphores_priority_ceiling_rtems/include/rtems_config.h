@@ -21,8 +21,24 @@
 
 #include <rtems.h>
 
+#include <cpu_usage.h>
+#include <lockprof.h>
+
 rtems_task Init(rtems_task_argument arg);
 
+/**
+ * Uncomment to bound the semaphore waits and start the deadlock watchdog
+ * of the lock profiler.
+ */
+// #define DEADLOCK_WATCHDOG
+
+/** Tasks of the deadlock watchdog */
+#ifdef DEADLOCK_WATCHDOG
+#define WATCHDOG_TASKS (1)
+#else
+#define WATCHDOG_TASKS (0)
+#endif
+
 /** Definition of the Console Driver */
 #define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
 
@@ -40,7 +56,7 @@ rtems_task Init(rtems_task_argument arg);
 
 
 /** Maximum number of tasks */
-#define CONFIGURE_MAXIMUM_TASKS      (4)
+#define CONFIGURE_MAXIMUM_TASKS      (7 + WATCHDOG_TASKS)
 
 /**
  * Extra stack memory needed for the tasks. It must include all the memory
@@ -59,6 +75,9 @@ rtems_task Init(rtems_task_argument arg);
                                            RTEMS_NO_TIMESLICE | \
                                            RTEMS_INTERRUPT_LEVEL(0))
 
+/** Per task CPU usage accounting and priority inversion detection */
+#define CONFIGURE_INITIAL_EXTENSIONS CPU_USAGE_EXTENSION, LOCKPROF_EXTENSION
+
 /** Ensure that the default initialization table is defined */
 #define CONFIGURE_RTEMS_INIT_TASKS_TABLE
 
@@ -0,0 +1,250 @@
+/*
+ * Asynchronous logging functions. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <async_log.h>
+
+typedef struct {
+
+	/** Tick of the call */
+	uint32_t tick;
+	/** Global order of the call, to merge the records of the same tick */
+	uint32_t seq;
+	/** Format string */
+	const char * fmt;
+	/** Arguments */
+	uint32_t args[LOG_MAX_ARGS];
+
+} log_record_t;
+
+typedef struct {
+
+	/** Next record to write, only modified by the owner task */
+	volatile unsigned int head;
+	/** Next record to print, only modified by the drain task */
+	volatile unsigned int tail;
+	/** Records dropped because the ring was full, only modified by the owner */
+	volatile unsigned int dropped;
+	/** Dropped records already reported, only modified by the drain task */
+	unsigned int reported;
+	/** Records */
+	log_record_t records[LOG_RING_SIZE];
+
+} log_ring_t;
+
+/** Compiler barrier: the record must be complete before it is published */
+#define LOG_BARRIER() __asm__ __volatile__ ("" : : : "memory")
+
+static log_ring_t log_rings[LOG_MAX_TASKS];
+
+/** Sequence number of the next record, of all the tasks */
+static uint32_t log_seq = 0;
+
+static rtems_id log_drain_id;
+
+void log_write(const char * fmt, int nargs, ...)
+{
+	unsigned int index, head;
+	rtems_interrupt_level level;
+	log_ring_t * ring;
+	log_record_t * record;
+	va_list ap;
+	int i;
+
+	index = rtems_get_index(_Thread_Executing->Object.id);
+
+	if (index >= LOG_MAX_TASKS)
+	{
+		// No ring for this task
+		return;
+	}
+
+	ring = &log_rings[index];
+	head = ring->head;
+
+	if (head - ring->tail >= LOG_RING_SIZE)
+	{
+		ring->dropped++;
+		return;
+	}
+
+	record = &ring->records[head & (LOG_RING_SIZE - 1)];
+
+	// The tick and the sequence number together, in the order of the calls
+	rtems_interrupt_disable(level);
+	rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &record->tick);
+	record->seq = log_seq++;
+	rtems_interrupt_enable(level);
+	record->fmt = fmt;
+
+	va_start(ap, nargs);
+	for (i = 0; i < nargs; i++)
+	{
+		record->args[i] = va_arg(ap, uint32_t);
+	}
+	va_end(ap);
+
+	LOG_BARRIER();
+	ring->head = head + 1;
+}
+
+/** Returns whether record a was written before record b */
+static int log_before(const log_record_t * a, const log_record_t * b)
+{
+	if (a->tick != b->tick)
+	{
+		return (int32_t)(a->tick - b->tick) < 0;
+	}
+	return (int32_t)(a->seq - b->seq) < 0;
+}
+
+/**
+ * Prints the oldest pending record of all the rings. Returns 0 if all the
+ * rings are empty.
+ */
+static int log_drain_one(void)
+{
+	log_ring_t * oldest = NULL;
+	log_record_t * record;
+	unsigned int i, dropped;
+
+	for (i = 0; i < LOG_MAX_TASKS; i++)
+	{
+		log_ring_t * ring = &log_rings[i];
+
+		dropped = ring->dropped;
+		if (dropped != ring->reported)
+		{
+			printf("LOG: %u records of task %u dropped\n",
+					dropped - ring->reported, i);
+			ring->reported = dropped;
+		}
+
+		if (ring->tail != ring->head)
+		{
+			if (oldest == NULL || log_before(
+					&ring->records[ring->tail & (LOG_RING_SIZE - 1)],
+					&oldest->records[oldest->tail & (LOG_RING_SIZE - 1)]))
+			{
+				oldest = ring;
+			}
+		}
+	}
+
+	if (oldest == NULL)
+	{
+		return 0;
+	}
+
+	LOG_BARRIER();
+	record = &oldest->records[oldest->tail & (LOG_RING_SIZE - 1)];
+
+	printf("%lu: ", (unsigned long) record->tick);
+	printf(record->fmt, record->args[0], record->args[1],
+			record->args[2], record->args[3]);
+
+	LOG_BARRIER();
+	oldest->tail++;
+
+	return 1;
+}
+
+static rtems_task log_drain(rtems_task_argument argument)
+{
+	for (;;)
+	{
+		while (log_drain_one())
+		{
+		}
+		rtems_task_wake_after(LOG_DRAIN_PERIOD);
+	}
+}
+
+#ifdef LOG_MEASURE_CALL_COST
+
+/** Number of calls of each kind measured */
+#define LOG_MEASURE_CALLS	(LOG_RING_SIZE / 2)
+
+static uint32_t log_uptime_ns(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000000 + uptime.tv_nsec;
+}
+
+/** Measures the cost of the old synchronous log call and of LOG_TIME */
+static void log_measure_call_cost(void)
+{
+	uint32_t start, sync_ns, async_ns, tick;
+	unsigned int index;
+	int i;
+
+	start = log_uptime_ns();
+	for (i = 0; i < LOG_MEASURE_CALLS; i++)
+	{
+		rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &tick);
+		printf("%lu: LOG measure %d\n", (unsigned long) tick, i);
+	}
+	sync_ns = log_uptime_ns() - start;
+
+	start = log_uptime_ns();
+	for (i = 0; i < LOG_MEASURE_CALLS; i++)
+	{
+		LOG_TIME("LOG measure %d\n", i);
+	}
+	async_ns = log_uptime_ns() - start;
+
+	// Discard the records of the measure
+	index = rtems_get_index(_Thread_Executing->Object.id);
+	if (index < LOG_MAX_TASKS)
+	{
+		log_rings[index].tail = log_rings[index].head;
+	}
+
+	printf("LOG call cost: printf %lu ns | async %lu ns\n",
+			(unsigned long)(sync_ns / LOG_MEASURE_CALLS),
+			(unsigned long)(async_ns / LOG_MEASURE_CALLS));
+}
+
+#endif
+
+rtems_status_code log_init(rtems_task_priority drain_priority)
+{
+	rtems_status_code status;
+
+#ifdef LOG_MEASURE_CALL_COST
+	log_measure_call_cost();
+#endif
+
+	status = rtems_task_create(rtems_build_name('L', 'O', 'G', 'D'),
+			drain_priority, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &log_drain_id);
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_task_start(log_drain_id, log_drain, 0);
+}
@@ -0,0 +1,215 @@
+/*
+ * Lock usage checker. This file is part of the RTEMS Course
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <lockcheck.h>
+
+/** Depth first search state of a resource */
+#define LOCKCHECK_UNVISITED		0
+#define LOCKCHECK_IN_PATH		1
+#define LOCKCHECK_DONE			2
+
+typedef struct {
+
+	const lockcheck_config_t * config;
+	/** Bitmap of the resources obtained while holding each resource */
+	uint32_t edges[LOCKCHECK_MAX_RESOURCES];
+	unsigned char state[LOCKCHECK_MAX_RESOURCES];
+	/** Current path of the search */
+	unsigned int path[LOCKCHECK_MAX_RESOURCES];
+	unsigned int depth;
+	unsigned int cycles;
+
+} lockcheck_graph_t;
+
+/** Name of a task that obtains resource while holding held */
+static const char * lockcheck_edge_task(const lockcheck_config_t * config,
+		unsigned int held, unsigned int resource)
+{
+	unsigned int i;
+
+	for (i = 0; i < config->use_count; i++)
+	{
+		if (config->uses[i].resource == resource &&
+				(config->uses[i].held & (1u << held)))
+		{
+			return config->tasks[config->uses[i].task].name;
+		}
+	}
+
+	return "?";
+}
+
+static void lockcheck_print_cycle(lockcheck_graph_t * graph, unsigned int to)
+{
+	const lockcheck_config_t * config = graph->config;
+	unsigned int from;
+	unsigned int i;
+
+	// The cycle starts where the path reaches the resource again
+	for (i = 0; graph->path[i] != to; i++)
+	{
+	}
+
+	printf("LOCKCHECK ERROR: lock order cycle:");
+	for (; i < graph->depth; i++)
+	{
+		from = graph->path[i];
+		printf(" %s -(%s)->", config->resources[from].name,
+				lockcheck_edge_task(config, from,
+						i + 1 < graph->depth ? graph->path[i + 1] : to));
+	}
+	printf(" %s\n", config->resources[to].name);
+
+	graph->cycles++;
+}
+
+static void lockcheck_visit(lockcheck_graph_t * graph, unsigned int resource)
+{
+	uint32_t pending = graph->edges[resource];
+	unsigned int next;
+
+	graph->state[resource] = LOCKCHECK_IN_PATH;
+	graph->path[graph->depth++] = resource;
+
+	while (pending != 0)
+	{
+		next = __builtin_ctz(pending);
+		pending &= pending - 1;
+
+		if (graph->state[next] == LOCKCHECK_IN_PATH)
+		{
+			lockcheck_print_cycle(graph, next);
+		}
+		else if (graph->state[next] == LOCKCHECK_UNVISITED)
+		{
+			lockcheck_visit(graph, next);
+		}
+	}
+
+	graph->depth--;
+	graph->state[resource] = LOCKCHECK_DONE;
+}
+
+unsigned int lockcheck_verify(const lockcheck_config_t * config,
+		rtems_task_priority ceilings[])
+{
+	static lockcheck_graph_t graph;
+	const lockcheck_use_t * use;
+	const lockcheck_resource_t * resource;
+	rtems_task_priority computed;
+	unsigned int errors = 0;
+	unsigned int held;
+	unsigned int i, j;
+
+	if (config->resource_count > LOCKCHECK_MAX_RESOURCES)
+	{
+		printf("LOCKCHECK ERROR: %u resources, the maximum is %u\n",
+				config->resource_count, LOCKCHECK_MAX_RESOURCES);
+		return 1;
+	}
+
+	for (i = 0; i < config->resource_count; i++)
+	{
+		graph.edges[i] = 0;
+		graph.state[i] = LOCKCHECK_UNVISITED;
+	}
+	graph.config = config;
+	graph.depth = 0;
+	graph.cycles = 0;
+
+	for (i = 0; i < config->use_count; i++)
+	{
+		use = &config->uses[i];
+		if (use->task >= config->task_count ||
+				use->resource >= config->resource_count)
+		{
+			printf("LOCKCHECK ERROR: use %u refers to an unknown task or "
+					"resource\n", i);
+			errors++;
+			continue;
+		}
+
+		// Obtaining a semaphore again while holding it only nests it
+		for (held = 0; held < config->resource_count; held++)
+		{
+			if ((use->held & (1u << held)) && held != use->resource)
+			{
+				graph.edges[held] |= 1u << use->resource;
+			}
+		}
+	}
+
+	if (errors > 0)
+	{
+		return errors;
+	}
+
+	// Ceilings: the highest priority (lowest number) among the users
+	for (i = 0; i < config->resource_count; i++)
+	{
+		resource = &config->resources[i];
+		computed = RTEMS_MAXIMUM_PRIORITY;
+
+		for (j = 0; j < config->use_count; j++)
+		{
+			use = &config->uses[j];
+			if (use->resource == i &&
+					config->tasks[use->task].priority < computed)
+			{
+				computed = config->tasks[use->task].priority;
+			}
+		}
+
+		ceilings[i] = resource->ceiling != 0 ? resource->ceiling : computed;
+
+		if (!(resource->protocol & RTEMS_PRIORITY_CEILING) ||
+				resource->ceiling == 0)
+		{
+			printf("LOCKCHECK: %s ceiling %lu\n", resource->name,
+					(unsigned long) computed);
+		}
+		else if (resource->ceiling < computed)
+		{
+			printf("LOCKCHECK WARNING: %s ceiling %lu is above its highest "
+					"user (%lu), tasks in between are blocked needlessly\n",
+					resource->name, (unsigned long) resource->ceiling,
+					(unsigned long) computed);
+		}
+		else if (resource->ceiling > computed)
+		{
+			printf("LOCKCHECK ERROR: %s ceiling %lu is below its highest "
+					"user (%lu)\n", resource->name,
+					(unsigned long) resource->ceiling, (unsigned long) computed);
+			errors++;
+		}
+	}
+
+	// Lock order: a cycle is reported for each back edge found
+	for (i = 0; i < config->resource_count; i++)
+	{
+		if (graph.state[i] == LOCKCHECK_UNVISITED)
+		{
+			lockcheck_visit(&graph, i);
+		}
+	}
+
+	return errors + graph.cycles;
+}
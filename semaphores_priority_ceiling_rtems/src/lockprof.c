@@ -0,0 +1,609 @@
+/*
+ * Lock contention profiler. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <lockprof.h>
+
+static lockprof_t lockprof_semaphores[LOCKPROF_MAX_SEMAPHORES];
+
+/** Kernel objects of the profiled semaphores, to read their holders */
+static Semaphore_Control * lockprof_controls[LOCKPROF_MAX_SEMAPHORES];
+
+static unsigned int lockprof_count = 0;
+
+/** Acquisitions at the previous report */
+static uint32_t lockprof_reported = 0;
+
+static rtems_id lockprof_task_id;
+
+typedef struct {
+
+	/** Waiting task, NULL when the slot is free */
+	Thread_Control * waiter;
+	rtems_id semaphore;
+	Semaphore_Control * control;
+	/** Holder of the longest inversion, and of the current one */
+	rtems_id holder;
+	rtems_id current_holder;
+
+	/** The CPU is currently given to a task below the waiter */
+	int inverted;
+	uint32_t inverted_since_us;
+	/** Inverted time of this wait, and the preemptor of its longest part */
+	uint32_t inversion_us;
+	uint32_t longest_us;
+	rtems_id preemptor;
+	rtems_id current_preemptor;
+
+	/** Slices waited in watchdog mode */
+	uint32_t slices;
+
+} lockprof_wait_t;
+
+/** Waits in progress, only modified with the interrupts disabled */
+static lockprof_wait_t lockprof_waits[LOCKPROF_MAX_WAITERS];
+static volatile unsigned int lockprof_wait_count = 0;
+
+static lockprof_inversions_t lockprof_inversions;
+
+/** The obtains without a timeout wait in slices */
+static int lockprof_watchdog = 0;
+
+static rtems_id lockprof_watchdog_id;
+
+/** Tasks, by index, in the deadlocks already printed */
+static uint32_t lockprof_deadlocked = 0;
+
+static uint32_t lockprof_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+/**
+ * Holder of a semaphore as the kernel sees it, 0 if it is free or it is a
+ * counting semaphore. Unlike the owner of the profile, it is right from
+ * the moment the semaphore is taken or handed over to a waiter.
+ */
+static rtems_id lockprof_holder(const Semaphore_Control * control)
+{
+	if (control == NULL ||
+			(control->attribute_set & RTEMS_SEMAPHORE_CLASS) ==
+					RTEMS_COUNTING_SEMAPHORE)
+	{
+		return 0;
+	}
+
+	return control->Core_control.mutex.holder_id;
+}
+
+static lockprof_t * lockprof_find(rtems_id id)
+{
+	unsigned int i;
+
+	for (i = 0; i < lockprof_count; i++)
+	{
+		if (lockprof_semaphores[i].id == id)
+		{
+			return &lockprof_semaphores[i];
+		}
+	}
+
+	return NULL;
+}
+
+const lockprof_t * lockprof_get(rtems_id id)
+{
+	return lockprof_find(id);
+}
+
+rtems_status_code lockprof_semaphore_create(const char * name,
+		rtems_name rtems_name, uint32_t count, rtems_attribute attribute_set,
+		rtems_task_priority priority_ceiling, rtems_id * id)
+{
+	rtems_status_code status;
+	Objects_Locations location;
+	lockprof_t * profile;
+
+	status = rtems_semaphore_create(rtems_name, count, attribute_set,
+			priority_ceiling, id);
+
+	if (status != RTEMS_SUCCESSFUL || lockprof_count >= LOCKPROF_MAX_SEMAPHORES)
+	{
+		return status;
+	}
+
+	profile = &lockprof_semaphores[lockprof_count++];
+	profile->id = *id;
+	profile->name = name;
+	profile->acquisitions = 0;
+	profile->contended = 0;
+	profile->total_wait_us = 0;
+	profile->max_wait_us = 0;
+	profile->total_hold_us = 0;
+	profile->max_hold_us = 0;
+	profile->max_wait_task = 0;
+	profile->max_wait_holder = 0;
+	profile->max_hold_task = 0;
+	profile->owner = 0;
+	profile->nest = 0;
+
+	// The semaphore is never deleted, so its control block stays valid
+	lockprof_controls[profile - lockprof_semaphores] = (Semaphore_Control *)
+			_Objects_Get(&_Semaphore_Information, *id, &location);
+	if (location == OBJECTS_LOCAL)
+	{
+		_Thread_Enable_dispatch();
+	}
+	else
+	{
+		lockprof_controls[profile - lockprof_semaphores] = NULL;
+	}
+
+	return RTEMS_SUCCESSFUL;
+}
+
+static void lockprof_wait_begin(lockprof_t * profile)
+{
+	uint32_t index = rtems_get_index(_Thread_Executing->Object.id);
+	rtems_interrupt_level level;
+	lockprof_wait_t * wait;
+
+	if (index >= LOCKPROF_MAX_WAITERS)
+	{
+		return;
+	}
+
+	wait = &lockprof_waits[index];
+
+	rtems_interrupt_disable(level);
+	wait->semaphore = profile->id;
+	wait->control = lockprof_controls[profile - lockprof_semaphores];
+	wait->holder = 0;
+	wait->inverted = 0;
+	wait->inversion_us = 0;
+	wait->longest_us = 0;
+	wait->preemptor = 0;
+	wait->slices = 0;
+	wait->waiter = _Thread_Executing;
+	lockprof_wait_count++;
+	rtems_interrupt_enable(level);
+}
+
+static void lockprof_wait_end(void)
+{
+	uint32_t index = rtems_get_index(_Thread_Executing->Object.id);
+	rtems_interrupt_level level;
+	lockprof_wait_t * wait;
+
+	if (index >= LOCKPROF_MAX_WAITERS || lockprof_waits[index].waiter == NULL)
+	{
+		return;
+	}
+
+	wait = &lockprof_waits[index];
+
+	// The waiter runs again, so the switch to it ended any inversion
+	rtems_interrupt_disable(level);
+	wait->waiter = NULL;
+	lockprof_wait_count--;
+	if (wait->inversion_us > 0)
+	{
+		lockprof_inversions.count++;
+		lockprof_inversions.total_us += wait->inversion_us;
+		if (wait->inversion_us > lockprof_inversions.max_us)
+		{
+			lockprof_inversions.max_us = wait->inversion_us;
+			lockprof_inversions.max_semaphore = wait->semaphore;
+			lockprof_inversions.max_waiter = _Thread_Executing->Object.id;
+			lockprof_inversions.max_holder = wait->holder;
+			lockprof_inversions.max_preemptor = wait->preemptor;
+		}
+	}
+	rtems_interrupt_enable(level);
+}
+
+/** Waits for the semaphore in slices, counting them */
+static rtems_status_code lockprof_obtain_sliced(lockprof_t * profile,
+		rtems_option option_set)
+{
+	uint32_t index = rtems_get_index(_Thread_Executing->Object.id);
+	rtems_interrupt_level level;
+	rtems_status_code status;
+
+	for (;;)
+	{
+		status = rtems_semaphore_obtain(profile->id, option_set,
+				LOCKPROF_WATCHDOG_SLICE);
+
+		if (status != RTEMS_TIMEOUT)
+		{
+			return status;
+		}
+
+		if (index < LOCKPROF_MAX_WAITERS)
+		{
+			rtems_interrupt_disable(level);
+			lockprof_waits[index].slices++;
+			rtems_interrupt_enable(level);
+		}
+	}
+}
+
+void lockprof_switch(Thread_Control * executing, Thread_Control * heir)
+{
+	lockprof_wait_t * wait;
+	uint32_t now_us, segment_us;
+	rtems_id holder;
+	int inverted;
+	unsigned int i;
+
+	if (lockprof_wait_count == 0)
+	{
+		return;
+	}
+
+	now_us = lockprof_uptime_us();
+
+	for (i = 0; i < LOCKPROF_MAX_WAITERS; i++)
+	{
+		wait = &lockprof_waits[i];
+
+		if (wait->waiter == NULL)
+		{
+			continue;
+		}
+
+		// A task below the waiter gets the CPU instead of the holder. The
+		// holder is read from the kernel: it may have changed since the wait
+		// began, and a waiter that got the semaphore holds it before it runs.
+		holder = lockprof_holder(wait->control);
+		inverted = heir != _Thread_Idle && heir->Object.id != holder &&
+				heir->current_priority > wait->waiter->current_priority;
+
+		if (inverted && !wait->inverted)
+		{
+			wait->inverted_since_us = now_us;
+			wait->current_preemptor = heir->Object.id;
+			wait->current_holder = holder;
+		}
+		else if (!inverted && wait->inverted)
+		{
+			segment_us = now_us - wait->inverted_since_us;
+			wait->inversion_us += segment_us;
+			if (segment_us > wait->longest_us)
+			{
+				wait->longest_us = segment_us;
+				wait->preemptor = wait->current_preemptor;
+				wait->holder = wait->current_holder;
+			}
+		}
+		wait->inverted = inverted;
+	}
+}
+
+void lockprof_get_inversions(lockprof_inversions_t * inversions)
+{
+	rtems_interrupt_level level;
+
+	rtems_interrupt_disable(level);
+	*inversions = lockprof_inversions;
+	rtems_interrupt_enable(level);
+}
+
+rtems_status_code lockprof_obtain(rtems_id id, rtems_option option_set,
+		rtems_interval timeout)
+{
+	lockprof_t * profile = lockprof_find(id);
+	rtems_id self = _Thread_Executing->Object.id;
+	rtems_interrupt_level level;
+	rtems_status_code status;
+	uint32_t start_us, wait_us = 0;
+	rtems_id holder = 0;
+	int contended = 0;
+
+	if (profile == NULL)
+	{
+		return rtems_semaphore_obtain(id, option_set, timeout);
+	}
+
+	status = rtems_semaphore_obtain(id, RTEMS_NO_WAIT, 0);
+
+	if (status == RTEMS_UNSATISFIED && !(option_set & RTEMS_NO_WAIT))
+	{
+		contended = 1;
+		holder = lockprof_holder(lockprof_controls[profile - lockprof_semaphores]);
+		lockprof_wait_begin(profile);
+		start_us = lockprof_uptime_us();
+		if (lockprof_watchdog && timeout == RTEMS_NO_TIMEOUT)
+		{
+			status = lockprof_obtain_sliced(profile, option_set);
+		}
+		else
+		{
+			status = rtems_semaphore_obtain(id, option_set, timeout);
+		}
+		wait_us = lockprof_uptime_us() - start_us;
+		lockprof_wait_end();
+	}
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	rtems_interrupt_disable(level);
+	profile->acquisitions++;
+	if (contended)
+	{
+		profile->contended++;
+		profile->total_wait_us += wait_us;
+		if (wait_us > profile->max_wait_us)
+		{
+			profile->max_wait_us = wait_us;
+			profile->max_wait_task = self;
+			profile->max_wait_holder = holder;
+		}
+	}
+	if (profile->nest++ == 0)
+	{
+		profile->owner = self;
+		profile->acquired_us = lockprof_uptime_us();
+	}
+	rtems_interrupt_enable(level);
+
+	return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code lockprof_release(rtems_id id)
+{
+	lockprof_t * profile = lockprof_find(id);
+	rtems_interrupt_level level;
+	uint32_t hold_us;
+
+	if (profile != NULL && profile->owner == _Thread_Executing->Object.id &&
+			profile->nest > 0)
+	{
+		// Account for the hold before the semaphore can be handed over
+		rtems_interrupt_disable(level);
+		if (--profile->nest == 0)
+		{
+			hold_us = lockprof_uptime_us() - profile->acquired_us;
+			profile->total_hold_us += hold_us;
+			if (hold_us > profile->max_hold_us)
+			{
+				profile->max_hold_us = hold_us;
+				profile->max_hold_task = profile->owner;
+			}
+			profile->owner = 0;
+		}
+		rtems_interrupt_enable(level);
+	}
+
+	return rtems_semaphore_release(id);
+}
+
+void lockprof_report(void)
+{
+	rtems_interrupt_level level;
+	lockprof_inversions_t inversions;
+	lockprof_t profile;
+	unsigned int i;
+
+	printf("LOCK PROFILE\n");
+
+	for (i = 0; i < lockprof_count; i++)
+	{
+		rtems_interrupt_disable(level);
+		profile = lockprof_semaphores[i];
+		rtems_interrupt_enable(level);
+
+		printf("  %-8s acq %lu contended %lu | wait us avg %lu max %lu "
+				"(0x%08lX behind 0x%08lX) | hold us avg %lu max %lu (0x%08lX)\n",
+				profile.name,
+				(unsigned long) profile.acquisitions,
+				(unsigned long) profile.contended,
+				(unsigned long)((profile.contended > 0) ?
+						profile.total_wait_us / profile.contended : 0),
+				(unsigned long) profile.max_wait_us,
+				(unsigned long) profile.max_wait_task,
+				(unsigned long) profile.max_wait_holder,
+				(unsigned long)((profile.acquisitions > 0) ?
+						profile.total_hold_us / profile.acquisitions : 0),
+				(unsigned long) profile.max_hold_us,
+				(unsigned long) profile.max_hold_task);
+	}
+
+	lockprof_get_inversions(&inversions);
+	if (inversions.count > 0)
+	{
+		printf("  INVERSIONS %lu, total %lu us | worst %lu us on 0x%08lX: "
+				"0x%08lX waits for 0x%08lX, preempted by 0x%08lX\n",
+				(unsigned long) inversions.count,
+				(unsigned long) inversions.total_us,
+				(unsigned long) inversions.max_us,
+				(unsigned long) inversions.max_semaphore,
+				(unsigned long) inversions.max_waiter,
+				(unsigned long) inversions.max_holder,
+				(unsigned long) inversions.max_preemptor);
+	}
+}
+
+/**
+ * Looks for cycles in the wait-for graph of the tasks stuck for at least a
+ * slice, and prints the ones not printed yet.
+ */
+static void lockprof_watchdog_check(void)
+{
+	/** Semaphore each task waits for, and the index of its holder */
+	lockprof_t * waits_for[LOCKPROF_MAX_WAITERS];
+	unsigned int next[LOCKPROF_MAX_WAITERS];
+	rtems_id ids[LOCKPROF_MAX_WAITERS];
+	unsigned char state[LOCKPROF_MAX_WAITERS];
+	rtems_interrupt_level level;
+	lockprof_wait_t * wait;
+	rtems_id holder;
+	uint32_t deadlocked = 0;
+	uint32_t cycle;
+	uint32_t now_us;
+	unsigned int i, node;
+
+	rtems_interrupt_disable(level);
+	for (i = 0; i < LOCKPROF_MAX_WAITERS; i++)
+	{
+		wait = &lockprof_waits[i];
+		waits_for[i] = NULL;
+		next[i] = LOCKPROF_MAX_WAITERS;
+		state[i] = 0;
+
+		if (wait->waiter != NULL && wait->slices > 0)
+		{
+			waits_for[i] = lockprof_find(wait->semaphore);
+			ids[i] = wait->waiter->Object.id;
+			holder = lockprof_holder(wait->control);
+			if (waits_for[i] != NULL && holder != 0)
+			{
+				next[i] = rtems_get_index(holder);
+			}
+		}
+	}
+	rtems_interrupt_enable(level);
+
+	now_us = lockprof_uptime_us();
+
+	// Every task waits for one holder at most: follow the chains, marking
+	// the nodes of the current chain with 1 and the explored ones with 2
+	for (i = 0; i < LOCKPROF_MAX_WAITERS; i++)
+	{
+		for (node = i; node < LOCKPROF_MAX_WAITERS && state[node] == 0;
+				node = next[node])
+		{
+			state[node] = 1;
+		}
+
+		if (node < LOCKPROF_MAX_WAITERS && state[node] == 1)
+		{
+			// The chain closed on itself: node is in a cycle
+			cycle = 0;
+			do
+			{
+				cycle |= 1u << node;
+				node = next[node];
+			} while (!(cycle & (1u << node)));
+
+			deadlocked |= cycle;
+
+			if ((lockprof_deadlocked & cycle) != cycle)
+			{
+				printf("DEADLOCK:");
+				do
+				{
+					printf(" 0x%08lX waits %s held by 0x%08lX for %lu us;",
+							(unsigned long) ids[node], waits_for[node]->name,
+							(unsigned long) ids[next[node]],
+							(unsigned long)(now_us - waits_for[node]->acquired_us));
+					node = next[node];
+					cycle &= ~(1u << node);
+				} while (cycle != 0);
+				printf("\n");
+			}
+		}
+
+		for (node = i; node < LOCKPROF_MAX_WAITERS && state[node] == 1;
+				node = next[node])
+		{
+			state[node] = 2;
+		}
+	}
+
+	// A deadlock is printed once, while its tasks remain stuck
+	lockprof_deadlocked = deadlocked;
+}
+
+static rtems_task lockprof_watchdog_task(rtems_task_argument argument)
+{
+	for (;;)
+	{
+		rtems_task_wake_after(LOCKPROF_WATCHDOG_PERIOD);
+		lockprof_watchdog_check();
+	}
+}
+
+static rtems_task lockprof_task(rtems_task_argument argument)
+{
+	uint32_t acquisitions;
+	unsigned int i;
+
+	for (;;)
+	{
+		rtems_task_wake_after(LOCKPROF_REPORT_PERIOD);
+
+		acquisitions = 0;
+		for (i = 0; i < lockprof_count; i++)
+		{
+			acquisitions += lockprof_semaphores[i].acquisitions;
+		}
+
+		if (acquisitions != lockprof_reported)
+		{
+			lockprof_reported = acquisitions;
+			lockprof_report();
+		}
+	}
+}
+
+rtems_status_code lockprof_init(void)
+{
+	rtems_status_code status;
+
+	status = rtems_task_create(rtems_build_name('L', 'P', 'R', 'F'),
+			LOCKPROF_REPORT_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &lockprof_task_id);
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_task_start(lockprof_task_id, lockprof_task, 0);
+}
+
+rtems_status_code lockprof_watchdog_init(void)
+{
+	rtems_status_code status;
+
+	status = rtems_task_create(rtems_build_name('L', 'W', 'D', 'G'),
+			LOCKPROF_WATCHDOG_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &lockprof_watchdog_id);
+
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	lockprof_watchdog = 1;
+
+	return rtems_task_start(lockprof_watchdog_id, lockprof_watchdog_task, 0);
+}
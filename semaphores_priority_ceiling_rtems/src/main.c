@@ -24,21 +24,54 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <async_log.h>
+
 #define PRINT(fmt,args...)  printf ( fmt "\n",\
                             ##args)
 
-#define PRINT_TIME(fmt,args...) do { \
-			unsigned int __current_tick; \
-			rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &__current_tick); \
-			printf ("%lu: " fmt "\n", __current_tick, ##args); \
-			} while (0)
+#define PRINT_TIME(fmt,args...) LOG_TIME(fmt "\n", ##args)
 
 #include <consume_ticks.h>
+#include <lockprof.h>
+#include <lockcheck.h>
 
 /** Two semaphores for two critical sections */
 rtems_id critical_section_ONE_sem;
 rtems_id critical_section_TWO_sem;
 
+/** Priorities of the tasks */
+#define T1_PRIORITY		10
+#define T2_PRIORITY		15
+#define T3_PRIORITY		20
+
+/** Tasks and semaphores, as declared to the lock usage checker */
+static const lockcheck_task_t lockcheck_tasks[] = {
+	{ "T1", T1_PRIORITY },
+	{ "T2", T2_PRIORITY },
+	{ "T3", T3_PRIORITY }
+};
+
+/** A zero ceiling takes the one computed from the users */
+static const lockcheck_resource_t lockcheck_resources[] = {
+	{ "Sem1", RTEMS_PRIORITY_CEILING, 0 },
+	{ "Sem2", RTEMS_PRIORITY_CEILING, 0 }
+};
+
+/** Task, semaphore obtained and semaphores held at that moment */
+static const lockcheck_use_t lockcheck_uses[] = {
+	{ 0, 0, 0 },
+	{ 0, 1, 0 },
+	{ 1, 1, 0 },
+	{ 2, 0, 0 }
+};
+
+static const lockcheck_config_t lockcheck_config = {
+	lockcheck_tasks, sizeof(lockcheck_tasks) / sizeof(lockcheck_tasks[0]),
+	lockcheck_resources,
+	sizeof(lockcheck_resources) / sizeof(lockcheck_resources[0]),
+	lockcheck_uses, sizeof(lockcheck_uses) / sizeof(lockcheck_uses[0])
+};
+
 rtems_task T1(rtems_task_argument argument)
 {
 	// TODO: Implement task's behaviour
@@ -46,18 +79,18 @@ rtems_task T1(rtems_task_argument argument)
 	PRINT_TIME("STARTING T1") ;
 	consume_ticks(4);
 	PRINT_TIME("TRYING TO GET SEMAPHORE 1 T1") ;
-	rtems_semaphore_obtain(critical_section_ONE_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+	lockprof_obtain(critical_section_ONE_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
 	PRINT_TIME("GOT SEMAPHORE 1 T1") ;
 	consume_ticks(3);
 	PRINT_TIME("RELEASING SEMAPHORE 1 T1") ;
-	rtems_semaphore_release(critical_section_ONE_sem);
+	lockprof_release(critical_section_ONE_sem);
 	consume_ticks(2);
 	PRINT_TIME("TRYING TO GET SEMAPHORE 2 T1") ;
-	rtems_semaphore_obtain(critical_section_TWO_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+	lockprof_obtain(critical_section_TWO_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
 	PRINT_TIME("GOT SEMAPHORE 2 T1") ;
 	consume_ticks(2) ;
 	PRINT_TIME("RELEASING SEMAPHORE 2 T1") ;
-	rtems_semaphore_release(critical_section_TWO_sem);
+	lockprof_release(critical_section_TWO_sem);
 	consume_ticks(2);
 	PRINT_TIME("Finishing T1") ;
 	rtems_task_delete(RTEMS_SELF);
@@ -70,11 +103,11 @@ rtems_task T2(rtems_task_argument argument)
 		PRINT_TIME("STARTING T2") ;
 		consume_ticks(2);
 		PRINT_TIME("TRYING TO GET SEMAPHORE 2 T2") ;
-		rtems_semaphore_obtain(critical_section_TWO_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+		lockprof_obtain(critical_section_TWO_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
 		PRINT_TIME("GOT SEMAPHORE 2 T2") ;
 		consume_ticks(4);
 		PRINT_TIME("RELEASING SEMAPHORE 2 T2") ;
-		rtems_semaphore_release(critical_section_TWO_sem);
+		lockprof_release(critical_section_TWO_sem);
 		consume_ticks(3);
 		PRINT_TIME("FINISHING_T2") ;
 		rtems_task_delete(RTEMS_SELF);
@@ -86,11 +119,11 @@ rtems_task T3(rtems_task_argument argument)
 	PRINT_TIME("STARTING T3") ;
 	consume_ticks(6);
 	PRINT_TIME("TRYING TO GET SEMAPHORE 1 T3") ;
-	rtems_semaphore_obtain(critical_section_ONE_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+	lockprof_obtain(critical_section_ONE_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
 	PRINT_TIME("GOT SEMAPHORE 1 T3") ;
 	consume_ticks(6);
 	PRINT_TIME("RELEASING SEMAPHORE 1 T3") ;
-	rtems_semaphore_release(critical_section_ONE_sem);
+	lockprof_release(critical_section_ONE_sem);
     consume_ticks(2);
 	PRINT_TIME("FINISHING_T3") ;
 	rtems_task_delete(RTEMS_SELF);
@@ -102,16 +135,41 @@ rtems_task Init(rtems_task_argument arg)
 	rtems_id T1_id;
 	rtems_id T2_id;
 	rtems_id T3_id;
+	rtems_task_priority ceilings[2];
+
+	// Calibrate the busy work against the clock, before any task runs
+	consume_calibrate();
+
+	// Start the asynchronous logging drain task
+	log_init(LOG_DRAIN_PRIORITY);
+
+	// Start the CPU usage reporter
+	cpu_usage_init(CPU_USAGE_REPORT_PRIORITY, CPU_USAGE_REPORT_PERIOD);
+
+	// Start the lock profile reporter
+	lockprof_init();
+
+#ifdef DEADLOCK_WATCHDOG
+	// Bound the semaphore waits and look for deadlocks
+	lockprof_watchdog_init();
+#endif
+
+	// Check the semaphore usage and compute the ceilings before creating them
+	if (lockcheck_verify(&lockcheck_config, ceilings) > 0)
+	{
+		PRINT("Lock usage errors, the tasks are not started");
+		rtems_task_delete(RTEMS_SELF);
+	}
 
 	// TODO: Create the semaphores
-	rtems_semaphore_create(rtems_build_name('s', 'e', 'm', '1'), 1,
-				RTEMS_PRIORITY | RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY_CEILING, 10, &critical_section_ONE_sem) ;
-	rtems_semaphore_create(rtems_build_name('s', 'e', 'm', '2'), 1,
-					RTEMS_PRIORITY | RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY_CEILING, 10, &critical_section_TWO_sem) ;
+	lockprof_semaphore_create("Sem1", rtems_build_name('s', 'e', 'm', '1'), 1,
+				RTEMS_PRIORITY | RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY_CEILING, ceilings[0], &critical_section_ONE_sem) ;
+	lockprof_semaphore_create("Sem2", rtems_build_name('s', 'e', 'm', '2'), 1,
+					RTEMS_PRIORITY | RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY_CEILING, ceilings[1], &critical_section_TWO_sem) ;
 
 	// Create T1
 	rtems_task_create(rtems_build_name('T', 'M', 'S', 'V'),
-			10, RTEMS_MINIMUM_STACK_SIZE,
+			T1_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
 			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
 			RTEMS_DEFAULT_ATTRIBUTES, &T1_id);
 
@@ -120,7 +178,7 @@ rtems_task Init(rtems_task_argument arg)
 
 	// Create T2
 	rtems_task_create(rtems_build_name('H', 's', 'k', 'p'),
-			15, RTEMS_MINIMUM_STACK_SIZE,
+			T2_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
 			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
 			RTEMS_DEFAULT_ATTRIBUTES, &T2_id);
 
@@ -129,7 +187,7 @@ rtems_task Init(rtems_task_argument arg)
 
 	// Create T3
 	rtems_task_create(rtems_build_name('A', 'C', 'S', 'T'),
-			20, RTEMS_MINIMUM_STACK_SIZE,
+			T3_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
 			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
 			RTEMS_DEFAULT_ATTRIBUTES, &T3_id);
 
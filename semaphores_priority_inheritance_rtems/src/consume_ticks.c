@@ -19,7 +19,33 @@
 #include <consume_ticks.h>
 #include <rtems.h>
 
-void consume_ticks(uint32_t ticks)
+/** Iterations of the busy loop between two clock reads while calibrating */
+#define CONSUME_CALIBRATION_CHUNK	10000
+
+/** Busy loop iterations per millisecond, 0 until calibrated */
+static uint32_t consume_iterations_per_ms = 0;
+
+static uint32_t consume_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+/** Busy loop: its duration only depends on the CPU time it gets */
+static void consume_loop(uint32_t iterations)
+{
+	volatile uint32_t counter = iterations;
+
+	while (counter > 0)
+	{
+		counter--;
+	}
+}
+
+static void consume_tick_edges(uint32_t ticks)
 {
 	uint32_t previous_tick, current_tick;
 
@@ -36,3 +62,59 @@ void consume_ticks(uint32_t ticks)
 	}
 
 }
+
+void consume_ticks(uint32_t ticks)
+{
+	if (consume_iterations_per_ms == 0)
+	{
+		consume_tick_edges(ticks);
+		return;
+	}
+
+	while (ticks > 0)
+	{
+		consume_cpu_us(rtems_configuration_get_microseconds_per_tick());
+		ticks--;
+	}
+}
+
+void consume_calibrate(void)
+{
+	uint32_t duration_us = CONSUME_CALIBRATION_TICKS *
+			rtems_configuration_get_microseconds_per_tick();
+	uint32_t iterations = 0;
+	uint32_t start_us, elapsed_us;
+
+	// Start right after a tick, so that the measure is not cut short
+	consume_tick_edges(1);
+
+	start_us = consume_uptime_us();
+	do
+	{
+		consume_loop(CONSUME_CALIBRATION_CHUNK);
+		iterations += CONSUME_CALIBRATION_CHUNK;
+		elapsed_us = consume_uptime_us() - start_us;
+	} while (elapsed_us < duration_us);
+
+	consume_iterations_per_ms =
+			(uint32_t)(((uint64_t) iterations * 1000) / elapsed_us);
+}
+
+void consume_cpu_us(uint32_t us)
+{
+	uint32_t us_per_tick = rtems_configuration_get_microseconds_per_tick();
+
+	if (consume_iterations_per_ms == 0)
+	{
+		consume_tick_edges((us + us_per_tick - 1) / us_per_tick);
+		return;
+	}
+
+	while (us >= 1000)
+	{
+		consume_loop(consume_iterations_per_ms);
+		us -= 1000;
+	}
+
+	consume_loop((us * consume_iterations_per_ms) / 1000);
+}
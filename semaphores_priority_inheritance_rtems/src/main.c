@@ -24,16 +24,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <async_log.h>
+
 #define PRINT(fmt,args...)  printf ( fmt "\n",\
                             ##args)
 
-#define PRINT_TIME(fmt,args...) do { \
-			unsigned int __current_tick; \
-			rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &__current_tick); \
-			printf ("%lu: " fmt "\n", __current_tick, ##args); \
-			} while (0)
+#define PRINT_TIME(fmt,args...) LOG_TIME(fmt "\n", ##args)
 
 #include <consume_ticks.h>
+#include <lockprof.h>
 
 /** The one and only semaphore */
 rtems_id critical_section_sem;
@@ -46,12 +45,12 @@ rtems_task T1(rtems_task_argument argument)
 	PRINT_TIME("STARTING T1") ;
 	consume_ticks(4);
 	PRINT_TIME("TRYING TO GET SEMAPHORE T1") ;
-	rtems_semaphore_obtain(critical_section_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+	lockprof_obtain(critical_section_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
 	PRINT_TIME("GOT SEMAPHORE T1") ;
 	consume_ticks(3);
 	PRINT_TIME("RELEASING SEMAPHORE T1") ;
 
-	rtems_semaphore_release(critical_section_sem);
+	lockprof_release(critical_section_sem);
 
 	consume_ticks(2);
 
@@ -79,12 +78,12 @@ rtems_task T3(rtems_task_argument argument)
 	PRINT_TIME("STARTING T3");
 	consume_ticks(6);
 	PRINT_TIME("TRYING TO GET SEMAPHORE T3") ;
-	rtems_semaphore_obtain(critical_section_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
+	lockprof_obtain(critical_section_sem, RTEMS_WAIT, RTEMS_NO_TIMEOUT) ;
 	PRINT_TIME("GOT SEMAPHORE T3") ;
 	consume_ticks(10);
 	PRINT_TIME("RELEASING SEMAPHORE T3") ;
 
-	rtems_semaphore_release(critical_section_sem);
+	lockprof_release(critical_section_sem);
 	consume_ticks(4);
 	PRINT_TIME("FINISHING  T3") ;
 
@@ -99,8 +98,25 @@ rtems_task Init(rtems_task_argument arg)
 	rtems_id T2_id;
 	rtems_id T3_id;
 
+	// Calibrate the busy work against the clock, before any task runs
+	consume_calibrate();
+
+	// Start the asynchronous logging drain task
+	log_init(LOG_DRAIN_PRIORITY);
+
+	// Start the CPU usage reporter
+	cpu_usage_init(CPU_USAGE_REPORT_PRIORITY, CPU_USAGE_REPORT_PERIOD);
+
+	// Start the lock profile reporter
+	lockprof_init();
+
+#ifdef DEADLOCK_WATCHDOG
+	// Bound the semaphore waits and look for deadlocks
+	lockprof_watchdog_init();
+#endif
+
 	// TODO: Create the semaphore
-	rtems_semaphore_create(rtems_build_name('s', 'e', 'm', '1'), 1,
+	lockprof_semaphore_create("Sem1", rtems_build_name('s', 'e', 'm', '1'), 1,
 			RTEMS_PRIORITY | RTEMS_BINARY_SEMAPHORE | RTEMS_INHERIT_PRIORITY, 0, &critical_section_sem) ;
 
 	// Create T1
@@ -4,16 +4,25 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/async_log.c \
 ../src/consume_ticks.c \
-../src/main.c 
+../src/cpu_usage.c \
+../src/main.c \
+../src/workload.c 
 
 OBJS += \
+./src/async_log.o \
 ./src/consume_ticks.o \
-./src/main.o 
+./src/cpu_usage.o \
+./src/main.o \
+./src/workload.o 
 
 C_DEPS += \
+./src/async_log.d \
 ./src/consume_ticks.d \
-./src/main.d 
+./src/cpu_usage.d \
+./src/main.d \
+./src/workload.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
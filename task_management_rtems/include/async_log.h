@@ -0,0 +1,93 @@
+/*
+ * Asynchronous logging functions. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ASYNC_LOG_H__
+#define __ASYNC_LOG_H__
+
+#include <rtems.h>
+
+/**
+ * Asynchronous logging. The calling task only stores a small binary record
+ * (tick, sequence number, format string address and up to LOG_MAX_ARGS
+ * 32-bit arguments) in its own ring buffer, without blocking. A low
+ * priority drain task formats and prints the records later on, merging
+ * the rings by tick and then by sequence number, so that the records of
+ * different tasks in the same tick keep the order of the calls. The
+ * sequence number is taken with the interrupts disabled for a few
+ * instructions.
+ *
+ * Each ring has a single producer (its task) and a single consumer (the
+ * drain task), so it needs no locking on a uniprocessor. As a consequence:
+ *
+ * - LOG_TIME must not be used from interrupt handlers.
+ * - Tasks whose ID index is LOG_MAX_TASKS or higher are not logged.
+ * - The arguments are printed later on: strings must be constant, and
+ *   64-bit or floating point arguments are not supported.
+ */
+
+/** Maximum number of 32-bit arguments of a log record */
+#define LOG_MAX_ARGS		4
+
+/** Records per task ring. It must be a power of two. */
+#define LOG_RING_SIZE		32
+
+/**
+ * Tasks with a ring, indexed by the index of their object ID: every task
+ * of the workload generator (4 + WORKLOAD_MAX_TASKS, from index 1)
+ */
+#define LOG_MAX_TASKS		72
+
+/**
+ * Default priority of the drain task: the lowest one, so that the records
+ * are printed when the system is idle
+ */
+#define LOG_DRAIN_PRIORITY	250
+
+/** Drain period, in ticks, when all the rings are empty */
+#define LOG_DRAIN_PERIOD	1
+
+/**
+ * Uncomment to measure, in log_init(), the cost of a log call in the
+ * calling task, synchronous (printf) and asynchronous.
+ */
+// #define LOG_MEASURE_CALL_COST
+
+/** Number of arguments of a LOG_TIME call (up to 8) */
+#define LOG_NARGS(args...) LOG_NARGS_(0, ##args, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, rest...) n
+
+/** Logs a message prefixed with the current tick */
+#define LOG_TIME(fmt,args...) do { \
+			(void) sizeof(char[(LOG_NARGS(args) <= LOG_MAX_ARGS) ? 1 : -1]); \
+			log_write(fmt, LOG_NARGS(args), ##args); \
+			} while (0)
+
+/**
+ * Creates and starts the drain task with the given priority. It must be
+ * called from Init. If the tasks of the system never leave the CPU idle,
+ * the drain task needs a priority higher than theirs to ever run.
+ */
+rtems_status_code log_init(rtems_task_priority drain_priority);
+
+/**
+ * Stores a log record in the ring of the calling task. If the ring is
+ * full, the record is dropped and counted. Use LOG_TIME instead.
+ */
+void log_write(const char * fmt, int nargs, ...);
+
+#endif // __ASYNC_LOG_H__
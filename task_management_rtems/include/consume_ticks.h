@@ -21,6 +21,29 @@
 
 #include <rtems.h>
 
+/** Number of ticks spent by consume_calibrate() */
+#define CONSUME_CALIBRATION_TICKS	10
+
+/**
+ * Occupies the CPU for the given number of ticks. Once calibrated, it
+ * burns ticks * CONFIGURE_MICROSECONDS_PER_TICK microseconds of CPU time
+ * of the calling task, as consume_cpu_us() does. Before the calibration,
+ * it waits for the given number of tick edges, preempted time included.
+ */
 void consume_ticks(uint32_t ticks);
 
+/**
+ * Measures the speed of the busy loop against the clock. It must be
+ * called from Init, before any other task is started, and it takes
+ * CONSUME_CALIBRATION_TICKS ticks.
+ */
+void consume_calibrate(void);
+
+/**
+ * Burns the given number of microseconds of CPU time of the calling task.
+ * The time the task is preempted is not counted. Without calibration, it
+ * falls back to consume_ticks() rounded up to whole ticks.
+ */
+void consume_cpu_us(uint32_t us);
+
 #endif // __CONSUME_TICKS_H__
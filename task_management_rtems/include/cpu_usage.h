@@ -0,0 +1,75 @@
+/*
+ * CPU usage accounting. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CPU_USAGE_H__
+#define __CPU_USAGE_H__
+
+#include <rtems.h>
+
+/**
+ * CPU usage accounting. A task switch user extension charges the time
+ * elapsed since the previous switch, measured with the uptime clock, to
+ * the task that leaves the CPU: a classic API task, the idle thread or
+ * any other thread. A low priority reporter task prints the utilization
+ * of each task since its previous report.
+ *
+ * To use it, include this file from rtems_config.h, define
+ * CONFIGURE_INITIAL_EXTENSIONS as CPU_USAGE_EXTENSION, add one task to
+ * CONFIGURE_MAXIMUM_TASKS and call cpu_usage_init() from Init.
+ */
+
+/**
+ * Tasks accounted, indexed by the index of their object ID: every task of
+ * the workload generator (4 + WORKLOAD_MAX_TASKS, from index 1)
+ */
+#define CPU_USAGE_MAX_TASKS		72
+
+/** Default priority of the reporter task */
+#define CPU_USAGE_REPORT_PRIORITY	248
+
+/** Default period, in ticks, of the reporter task */
+#define CPU_USAGE_REPORT_PERIOD		500
+
+/** Task switch extension. Use CPU_USAGE_EXTENSION instead. */
+void cpu_usage_switch(Thread_Control * executing, Thread_Control * heir);
+
+/** User extensions table entry of the CPU usage accounting */
+#define CPU_USAGE_EXTENSION { \
+		NULL,				/* task create */ \
+		NULL,				/* task start */ \
+		NULL,				/* task restart */ \
+		NULL,				/* task delete */ \
+		cpu_usage_switch,	/* task switch */ \
+		NULL,				/* task begin */ \
+		NULL,				/* task exitted */ \
+		NULL				/* fatal */ \
+		}
+
+/**
+ * Creates and starts the reporter task with the given priority and
+ * period, in ticks. It must be called from Init. If the tasks of the
+ * system never leave the CPU idle, the reporter needs a priority higher
+ * than theirs to ever run.
+ */
+rtems_status_code cpu_usage_init(rtems_task_priority priority,
+		rtems_interval period);
+
+/** Prints the CPU usage of each task since the previous report */
+void cpu_usage_report(void);
+
+#endif // __CPU_USAGE_H__
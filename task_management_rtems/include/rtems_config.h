@@ -21,8 +21,17 @@
 
 #include <rtems.h>
 
+#include <cpu_usage.h>
+#include <workload.h>
+
 rtems_task Init(rtems_task_argument arg);
 
+/**
+ * Uncomment to run the synthetic workload of main.c instead of the two
+ * tasks demo.
+ */
+// #define WORKLOAD_GENERATOR
+
 /** Definition of the Console Driver */
 #define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
 
@@ -35,11 +44,26 @@ rtems_task Init(rtems_task_argument arg);
 /** Default value of ticks per timeslice */
 #define CONFIGURE_TICKS_PER_TIMESLICE (50)
 
+#ifdef WORKLOAD_GENERATOR
+
+/** Maximum number of semaphores */
+#define CONFIGURE_MAXIMUM_SEMAPHORES (WORKLOAD_MAX_RESOURCES)
+
+/** Maximum number of tasks: Init, log drain, CPU usage and workload monitor */
+#define CONFIGURE_MAXIMUM_TASKS      (4 + WORKLOAD_MAX_TASKS)
+
+/** Maximum number of rate monotonic periods */
+#define CONFIGURE_MAXIMUM_PERIODS    (WORKLOAD_MAX_TASKS)
+
+#else
+
 /** Maximum number of semaphores */
 #define CONFIGURE_MAXIMUM_SEMAPHORES (0)
 
 /** Maximum number of tasks */
-#define CONFIGURE_MAXIMUM_TASKS      (3)
+#define CONFIGURE_MAXIMUM_TASKS      (5)
+
+#endif
 
 
 /**
@@ -59,6 +83,9 @@ rtems_task Init(rtems_task_argument arg);
                                            RTEMS_NO_TIMESLICE | \
                                            RTEMS_INTERRUPT_LEVEL(0))
 
+/** Per task CPU usage accounting */
+#define CONFIGURE_INITIAL_EXTENSIONS CPU_USAGE_EXTENSION
+
 /** Ensure that the default initialization table is defined */
 #define CONFIGURE_RTEMS_INIT_TASKS_TABLE
 
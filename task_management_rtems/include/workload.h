@@ -0,0 +1,93 @@
+/*
+ * Synthetic workload generator. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WORKLOAD_H__
+#define __WORKLOAD_H__
+
+#include <rtems.h>
+
+/**
+ * Synthetic workload generator. A table of periodic tasks is turned into
+ * RTEMS tasks at Init. Each job of a task burns its WCET of CPU time with
+ * consume_cpu_us(), part of it inside the critical sections of the shared
+ * resources it uses, and it is released by a rate monotonic period after
+ * an initial phase. Deadlines are equal to periods.
+ *
+ * The response time of every job is measured from its nominal release.
+ * Deadline misses are logged by the task that misses them and counted.
+ * LOG_MAX_TASKS and CPU_USAGE_MAX_TASKS cover every task of the table. A monitor
+ * task prints the statistics of all the tasks every WORKLOAD_REPORT_PERIOD
+ * ticks, whenever the workload leaves it some CPU time.
+ */
+
+/** Maximum number of tasks of the table */
+#define WORKLOAD_MAX_TASKS		64
+
+/** Maximum number of shared resources (semaphores) */
+#define WORKLOAD_MAX_RESOURCES		8
+
+/** Priority of the monitor task */
+#define WORKLOAD_MONITOR_PRIORITY	249
+
+/** Period, in ticks, of the monitor task */
+#define WORKLOAD_REPORT_PERIOD		1000
+
+/** Shared resources are binary semaphores with priority inheritance */
+#define WORKLOAD_RESOURCE_ATTRIBUTES	(RTEMS_BINARY_SEMAPHORE | \
+		RTEMS_PRIORITY | RTEMS_INHERIT_PRIORITY)
+
+typedef struct {
+
+	/** Name used in the logs */
+	const char * name;
+	/** Period and relative deadline, in ticks */
+	rtems_interval period;
+	/** Execution time of each job, in microseconds */
+	uint32_t wcet_us;
+	rtems_task_priority priority;
+	/** Delay of the first release, in ticks */
+	rtems_interval phase;
+	/** Bitmap of the resources used by each job, in increasing order */
+	uint32_t resources;
+	/** Time spent inside each critical section, part of the WCET */
+	uint32_t section_us;
+
+} workload_task_config_t;
+
+typedef struct {
+
+	uint32_t jobs;
+	uint32_t misses;
+	uint32_t min_response_us;
+	uint32_t max_response_us;
+	uint64_t total_response_us;
+
+} workload_task_stats_t;
+
+/**
+ * Creates the resources used by the table, then creates and starts its
+ * tasks and the monitor task. It must be called from Init. The table must
+ * remain valid while the tasks run.
+ */
+rtems_status_code workload_start(const workload_task_config_t * table,
+		unsigned int count);
+
+/** Prints the statistics of all the tasks */
+void workload_report(void);
+
+#endif // __WORKLOAD_H__
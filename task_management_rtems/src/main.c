@@ -24,16 +24,35 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <async_log.h>
+
 #define PRINT(fmt,args...)  printf ( fmt "\n",\
                             ##args)
 
-#define PRINT_TIME(fmt,args...) do { \
-			uint32_t __current_tick; \
-			rtems_clock_get(RTEMS_CLOCK_GET_TICKS_SINCE_BOOT, &__current_tick); \
-			printf ("%lu: " fmt "\n", __current_tick, ##args); \
-			} while (0)
+#define PRINT_TIME(fmt,args...) LOG_TIME(fmt "\n", ##args)
 
 #include <consume_ticks.h>
+#include <workload.h>
+
+#ifdef WORKLOAD_GENERATOR
+
+/**
+ * Synthetic workload: name, period (ticks), WCET (us), priority, phase
+ * (ticks), resources bitmap and critical section length (us). Rate
+ * monotonic priorities, with 10 ms ticks: 15% + 20% + 12% + 12% + 8% + 8%
+ * = 75% of utilization, above the Liu & Layland bound for six tasks
+ * (73%), so the blocking of the critical sections can miss deadlines.
+ */
+const workload_task_config_t workload_table[] = {
+	{ "W_HK",	10,	15000,	10,	0,	0x1,	5000 },
+	{ "W_ACS",	20,	40000,	11,	0,	0x1,	10000 },
+	{ "W_TM",	25,	30000,	12,	1,	0x2,	10000 },
+	{ "W_TC",	50,	60000,	13,	2,	0x3,	15000 },
+	{ "W_FDIR",	100,	80000,	14,	0,	0x2,	20000 },
+	{ "W_PL",	200,	160000,	15,	5,	0x0,	0 },
+};
+
+#endif
 
 /**
  * First task.
@@ -79,9 +98,32 @@ rtems_task second_task(rtems_task_argument argument)
 
 rtems_task Init(rtems_task_argument arg)
 {
+#ifndef WORKLOAD_GENERATOR
 	rtems_id first_task_id;
 	rtems_id second_task_id;
-
+#endif
+
+	// Calibrate the busy work against the clock, before any task runs
+	consume_calibrate();
+
+#ifdef WORKLOAD_GENERATOR
+	// The workload leaves idle time: the instrumentation runs below it, so
+	// that the response times it reports do not include its own
+	log_init(LOG_DRAIN_PRIORITY);
+	cpu_usage_init(CPU_USAGE_REPORT_PRIORITY, CPU_USAGE_REPORT_PERIOD);
+#else
+	// Start the asynchronous logging drain task. Both tasks are CPU bound
+	// and never block, so the drain task must have a higher priority.
+	log_init(5);
+
+	// Start the CPU usage reporter, above the drain task for the same reason
+	cpu_usage_init(4, CPU_USAGE_REPORT_PERIOD);
+#endif
+
+#ifdef WORKLOAD_GENERATOR
+	workload_start(workload_table,
+			sizeof(workload_table) / sizeof(workload_table[0]));
+#else
 	// TODO: Create first task
 
 	// TODO: Start first task
@@ -100,6 +142,7 @@ rtems_task Init(rtems_task_argument arg)
 	RTEMS_DEFAULT_MODES,
 	RTEMS_DEFAULT_ATTRIBUTES, &second_task_id);
 	rtems_task_start(second_task_id, second_task, 0);
+#endif
 
 	/** Delete the initial task from the system */
 
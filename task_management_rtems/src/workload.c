@@ -0,0 +1,251 @@
+/*
+ * Synthetic workload generator. This file is part of the RTEMS Course 
+ * Copyright (C) 2017-2020 University of Alcalá
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <rtems.h>
+#include <stdio.h>
+
+#include <async_log.h>
+#include <consume_ticks.h>
+#include <workload.h>
+
+typedef struct {
+
+	const workload_task_config_t * config;
+	rtems_id task_id;
+	rtems_id period_id;
+	/** Only modified by the task, read by the monitor */
+	workload_task_stats_t stats;
+
+} workload_task_t;
+
+static workload_task_t workload_tasks[WORKLOAD_MAX_TASKS];
+
+static unsigned int workload_count = 0;
+
+static rtems_id workload_resources[WORKLOAD_MAX_RESOURCES];
+
+static rtems_id workload_monitor_id;
+
+static uint32_t workload_uptime_us(void)
+{
+	struct timespec uptime;
+
+	rtems_clock_get_uptime(&uptime);
+
+	return (uint32_t) uptime.tv_sec * 1000000 + uptime.tv_nsec / 1000;
+}
+
+static void workload_job(const workload_task_config_t * config)
+{
+	uint32_t pending = config->resources;
+	uint32_t remaining_us = config->wcet_us;
+	uint32_t section_us;
+	int r;
+
+	// Execution outside of the critical sections first
+	section_us = config->section_us * __builtin_popcount(pending);
+	if (section_us < remaining_us)
+	{
+		consume_cpu_us(remaining_us - section_us);
+	}
+
+	while (pending != 0)
+	{
+		r = __builtin_ctz(pending);
+		pending &= pending - 1;
+
+		rtems_semaphore_obtain(workload_resources[r], RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+		consume_cpu_us(config->section_us);
+		rtems_semaphore_release(workload_resources[r]);
+	}
+}
+
+static rtems_task workload_task(rtems_task_argument argument)
+{
+	workload_task_t * task = &workload_tasks[argument];
+	const workload_task_config_t * config = task->config;
+	workload_task_stats_t * stats = &task->stats;
+	uint32_t period_us = config->period *
+			rtems_configuration_get_microseconds_per_tick();
+	uint32_t release_us = 0;
+	uint32_t response_us;
+	rtems_status_code status;
+
+	// The period belongs to the task that creates it
+	rtems_rate_monotonic_create(
+			rtems_build_name('W', 'P', '0' + argument / 10, '0' + argument % 10),
+			&task->period_id);
+
+	if (config->phase > 0)
+	{
+		rtems_task_wake_after(config->phase);
+	}
+
+	for (;;)
+	{
+		status = rtems_rate_monotonic_period(task->period_id, config->period);
+
+		if (stats->jobs == 0 || status == RTEMS_TIMEOUT)
+		{
+			// The period (re)starts now
+			release_us = workload_uptime_us();
+		}
+		else
+		{
+			release_us += period_us;
+		}
+
+		workload_job(config);
+
+		response_us = workload_uptime_us() - release_us;
+
+		stats->jobs++;
+		stats->total_response_us += response_us;
+		if (response_us < stats->min_response_us)
+		{
+			stats->min_response_us = response_us;
+		}
+		if (response_us > stats->max_response_us)
+		{
+			stats->max_response_us = response_us;
+		}
+		if (response_us > period_us)
+		{
+			stats->misses++;
+			LOG_TIME("%s - DEADLINE MISS: job %lu, response %lu us\n",
+					config->name, (unsigned long) stats->jobs,
+					(unsigned long) response_us);
+		}
+	}
+}
+
+void workload_report(void)
+{
+	rtems_interrupt_level level;
+	workload_task_stats_t stats;
+	unsigned int i;
+
+	printf("WORKLOAD: %u tasks\n", workload_count);
+
+	for (i = 0; i < workload_count; i++)
+	{
+		rtems_interrupt_disable(level);
+		stats = workload_tasks[i].stats;
+		rtems_interrupt_enable(level);
+
+		printf("  %-8s prio %3lu T %5lu C %8lu us | jobs %6lu misses %4lu | "
+				"response us min %lu avg %lu max %lu\n",
+				workload_tasks[i].config->name,
+				(unsigned long) workload_tasks[i].config->priority,
+				(unsigned long) workload_tasks[i].config->period,
+				(unsigned long) workload_tasks[i].config->wcet_us,
+				(unsigned long) stats.jobs,
+				(unsigned long) stats.misses,
+				(unsigned long)((stats.jobs > 0) ? stats.min_response_us : 0),
+				(unsigned long)((stats.jobs > 0) ? stats.total_response_us / stats.jobs : 0),
+				(unsigned long) stats.max_response_us);
+	}
+}
+
+static rtems_task workload_monitor(rtems_task_argument argument)
+{
+	for (;;)
+	{
+		rtems_task_wake_after(WORKLOAD_REPORT_PERIOD);
+
+		workload_report();
+	}
+}
+
+rtems_status_code workload_start(const workload_task_config_t * table,
+		unsigned int count)
+{
+	rtems_status_code status;
+	uint32_t resources = 0;
+	unsigned int i;
+	int r;
+
+	if (count > WORKLOAD_MAX_TASKS)
+	{
+		return RTEMS_TOO_MANY;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		resources |= table[i].resources;
+	}
+
+	if (resources >> WORKLOAD_MAX_RESOURCES)
+	{
+		return RTEMS_INVALID_NUMBER;
+	}
+
+	for (r = 0; r < WORKLOAD_MAX_RESOURCES; r++)
+	{
+		if (resources & (1U << r))
+		{
+			status = rtems_semaphore_create(rtems_build_name('W', 'R', 'S', '0' + r),
+					1, WORKLOAD_RESOURCE_ATTRIBUTES, 0, &workload_resources[r]);
+			if (status != RTEMS_SUCCESSFUL)
+			{
+				return status;
+			}
+		}
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		workload_task_t * task = &workload_tasks[i];
+
+		task->config = &table[i];
+		task->stats.jobs = 0;
+		task->stats.misses = 0;
+		task->stats.min_response_us = 0xFFFFFFFF;
+		task->stats.max_response_us = 0;
+		task->stats.total_response_us = 0;
+
+		status = rtems_task_create(
+				rtems_build_name('W', '0' + i / 10, '0' + i % 10, ' '),
+				table[i].priority, RTEMS_MINIMUM_STACK_SIZE,
+				RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+				RTEMS_DEFAULT_ATTRIBUTES, &task->task_id);
+		if (status != RTEMS_SUCCESSFUL)
+		{
+			return status;
+		}
+
+		workload_count++;
+	}
+
+	// Start all the tasks at once, after they have all been created
+	for (i = 0; i < count; i++)
+	{
+		rtems_task_start(workload_tasks[i].task_id, workload_task, i);
+	}
+
+	status = rtems_task_create(rtems_build_name('W', 'M', 'O', 'N'),
+			WORKLOAD_MONITOR_PRIORITY, RTEMS_MINIMUM_STACK_SIZE,
+			RTEMS_PREEMPT | RTEMS_NO_TIMESLICE,
+			RTEMS_DEFAULT_ATTRIBUTES, &workload_monitor_id);
+	if (status != RTEMS_SUCCESSFUL)
+	{
+		return status;
+	}
+
+	return rtems_task_start(workload_monitor_id, workload_monitor, 0);
+}